@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "BatchKinematics.h"
+#include "PhaseProfiler.h"
+
+const ::std::size_t BatchKinematics::DOF;
+
+const ::std::size_t BatchKinematics::BODIES;
+
+BatchKinematics::Block::Block() :
+  count(0),
+  data(),
+  c(),
+  s()
+{
+}
+
+void
+BatchKinematics::Block::getFrame(const ::std::size_t& b, const ::std::size_t& k, ::rl::math::Transform& frame) const
+{
+  frame.setIdentity();
+
+  for (::std::size_t i = 0; i < 3; ++i)
+  {
+    for (::std::size_t j = 0; j < 3; ++j)
+    {
+      frame.linear()(i, j) = this->component(b, i * 3 + j)[k];
+    }
+
+    frame.translation()(i) = this->component(b, 9 + i)[k];
+  }
+}
+
+::rl::math::Vector3
+BatchKinematics::Block::getPosition(const ::std::size_t& b, const ::std::size_t& k) const
+{
+  return ::rl::math::Vector3(this->component(b, 9)[k], this->component(b, 10)[k], this->component(b, 11)[k]);
+}
+
+BatchKinematics::BatchKinematics() :
+  blockSize(16),
+  joints(DOF),
+  base(::rl::math::Transform::Identity()),
+  tool(::rl::math::Transform::Identity()),
+  valid(false)
+{
+}
+
+BatchKinematics::~BatchKinematics()
+{
+}
+
+void
+BatchKinematics::apply(const Block& block, const ::std::size_t& k, ::rl::plan::Model& model) const
+{
+  ::rl::math::Transform frame;
+
+  for (::std::size_t b = 0; b < BODIES; ++b)
+  {
+    block.getFrame(b, k, frame);
+    model.model->getBody(b)->setFrame(frame);
+  }
+}
+
+bool
+BatchKinematics::calibrate(::rl::plan::Model& model)
+{
+  this->valid = false;
+
+  if (DOF != model.getDof() || BODIES != model.getBodies() || 1 != model.getOperationalDof())
+  {
+    return false;
+  }
+
+  // At q = 0 every Rz(q(i)) is the identity, what remains are the fixed transforms
+  ::rl::math::Vector q = ::rl::math::Vector::Zero(DOF);
+  model.setPosition(q);
+  model.updateFrames();
+
+  this->base = model.getBody(0);
+
+  for (::std::size_t i = 0; i < DOF; ++i)
+  {
+    this->joints[i] = model.getBody(i).inverse() * model.getBody(i + 1);
+  }
+
+  this->tool = model.getBody(DOF).inverse() * model.forwardPosition(0);
+
+  // The chain and the linear interpolation must match the model everywhere
+  ::std::mt19937 engine(0);
+  ::std::uniform_real_distribution< ::rl::math::Real > distribution(0, 1);
+  ::rl::math::Vector minimum = model.getMinimum();
+  ::rl::math::Vector maximum = model.getMaximum();
+  ::rl::math::Vector u(DOF);
+  ::rl::math::Vector v(DOF);
+  ::rl::math::Vector inter(DOF);
+  ::std::vector< ::rl::math::Real > alphas(1, 0.3f);
+  Block block;
+
+  for (::std::size_t n = 0; n < 10; ++n)
+  {
+    for (::std::size_t i = 0; i < DOF; ++i)
+    {
+      u(i) = minimum(i) + distribution(engine) * (maximum(i) - minimum(i));
+      v(i) = minimum(i) + distribution(engine) * (maximum(i) - minimum(i));
+    }
+
+    model.interpolate(u, v, alphas[0], inter);
+
+    if (!inter.isApprox(u + alphas[0] * (v - u), 1.0e-9f))
+    {
+      return false;
+    }
+
+    this->compute(u, v, alphas, block);
+    model.setPosition(inter);
+    model.updateFrames();
+
+    ::rl::math::Transform frame;
+
+    for (::std::size_t b = 0; b < BODIES; ++b)
+    {
+      block.getFrame(b, 0, frame);
+
+      if (!frame.isApprox(model.getBody(b), 1.0e-6f))
+      {
+        return false;
+      }
+    }
+
+    block.getFrame(BODIES, 0, frame);
+
+    if (!frame.isApprox(model.forwardPosition(0), 1.0e-6f))
+    {
+      return false;
+    }
+  }
+
+  this->valid = true;
+  return true;
+}
+
+void
+BatchKinematics::compute(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::std::vector< ::rl::math::Real >& alphas, Block& block) const
+{
+  PROFILE_SCOPE(KINEMATICS);
+
+  const ::std::size_t n = alphas.size();
+  block.count = n;
+  block.data.resize((BODIES + 1) * 12 * n);
+  block.c.resize(n);
+  block.s.resize(n);
+
+  for (::std::size_t j = 0; j < 12; ++j)
+  {
+    ::rl::math::Real value = j < 9 ? this->base.linear()(j / 3, j % 3) : this->base.translation()(j - 9);
+    ::std::fill(block.component(0, j), block.component(0, j) + n, value);
+  }
+
+  for (::std::size_t i = 0; i <= DOF; ++i)
+  {
+    const ::rl::math::Transform& fixed = i < DOF ? this->joints[i] : this->tool;
+    ::rl::math::Real* c = block.c.data();
+    ::rl::math::Real* s = block.s.data();
+
+    if (i < DOF)
+    {
+      for (::std::size_t k = 0; k < n; ++k)
+      {
+        ::rl::math::Real q = u(i) + alphas[k] * (v(i) - u(i));
+        c[k] = ::std::cos(q);
+        s[k] = ::std::sin(q);
+      }
+    }
+    else
+    {
+      // The tool is fixed to the last body
+      ::std::fill(c, c + n, 1);
+      ::std::fill(s, s + n, 0);
+    }
+
+    // next = previous * Rz * fixed, Rz * fixed mixes the first two rows of fixed
+    for (::std::size_t row = 0; row < 3; ++row)
+    {
+      const ::rl::math::Real* r0 = block.component(i, row * 3 + 0);
+      const ::rl::math::Real* r1 = block.component(i, row * 3 + 1);
+      const ::rl::math::Real* r2 = block.component(i, row * 3 + 2);
+
+      for (::std::size_t col = 0; col < 4; ++col)
+      {
+        ::rl::math::Real f0 = col < 3 ? fixed.linear()(0, col) : fixed.translation()(0);
+        ::rl::math::Real f1 = col < 3 ? fixed.linear()(1, col) : fixed.translation()(1);
+        ::rl::math::Real f2 = col < 3 ? fixed.linear()(2, col) : fixed.translation()(2);
+        ::rl::math::Real* out = block.component(i + 1, col < 3 ? row * 3 + col : 9 + row);
+        const ::rl::math::Real* offset = col < 3 ? NULL : block.component(i, 9 + row);
+
+        for (::std::size_t k = 0; k < n; ++k)
+        {
+          ::rl::math::Real m0 = c[k] * f0 - s[k] * f1;
+          ::rl::math::Real m1 = s[k] * f0 + c[k] * f1;
+          out[k] = r0[k] * m0 + r1[k] * m1 + r2[k] * f2;
+        }
+
+        if (NULL != offset)
+        {
+          for (::std::size_t k = 0; k < n; ++k)
+          {
+            out[k] += offset[k];
+          }
+        }
+      }
+    }
+  }
+}
+
+::std::size_t
+BatchKinematics::firstCollision(::rl::plan::SimpleModel* model, const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::std::vector< ::rl::math::Real >& alphas, ::std::size_t& queries) const
+{
+  ::rl::math::Vector q(u.size());
+
+  if (!this->valid)
+  {
+    for (::std::size_t k = 0; k < alphas.size(); ++k)
+    {
+      model->interpolate(u, v, alphas[k], q);
+      model->setPosition(q);
+      {
+        PROFILE_SCOPE(KINEMATICS);
+        model->updateFrames();
+      }
+      ++queries;
+
+      if (model->isColliding())
+      {
+        return k;
+      }
+    }
+
+    return alphas.size();
+  }
+
+  // One block per thread, reused across calls
+  static thread_local Block block;
+  ::std::vector< ::rl::math::Real > blockAlphas;
+
+  for (::std::size_t first = 0; first < alphas.size(); first += this->blockSize)
+  {
+    ::std::size_t last = ::std::min(first + this->blockSize, alphas.size());
+    blockAlphas.assign(alphas.begin() + first, alphas.begin() + last);
+    this->compute(u, v, blockAlphas, block);
+
+    for (::std::size_t k = 0; k < block.size(); ++k)
+    {
+      // The position is kept for the models that record it, frames come from the block
+      model->interpolate(u, v, blockAlphas[k], q);
+      model->setPosition(q);
+      this->apply(block, k, *model);
+      ++queries;
+
+      if (model->isColliding())
+      {
+        return first + k;
+      }
+    }
+  }
+
+  return alphas.size();
+}
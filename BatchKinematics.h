@@ -0,0 +1,99 @@
+#ifndef _BATCH_KINEMATICS_H_
+#define _BATCH_KINEMATICS_H_
+
+#include <vector>
+#include <rl/plan/Model.h>
+#include <rl/plan/SimpleModel.h>
+
+/**
+*	Forward kinematics of a 6-DOF serial chain for a whole block of
+*	configurations along a segment at once. Every joint rotates the next body
+*	about the z axis of the previous one (Denavit-Hartenberg), so body i + 1
+*	is body i times Rz(q(i)) times a fixed transform. calibrate() reads these
+*	transforms and the tool transform from the model at q = 0 and verifies the
+*	chain against the model at random configurations.
+*
+*	The frames of a block are stored one component at a time over all
+*	configurations, so the loops run over configurations and vectorize.
+*/
+class BatchKinematics
+{
+public:
+  /** Frames of the bodies and the tool for a block of configurations */
+  class Block
+  {
+  public:
+    Block();
+
+    /** Number of configurations in the block */
+    ::std::size_t size() const { return count; }
+
+    /** Frame of body b of configuration k, b = BODIES is the tool */
+    void getFrame(const ::std::size_t& b, const ::std::size_t& k, ::rl::math::Transform& frame) const;
+
+    ::rl::math::Vector3 getPosition(const ::std::size_t& b, const ::std::size_t& k) const;
+
+  protected:
+    friend class BatchKinematics;
+
+    /** Component c (rotation row-major, then translation) of frame b for every configuration */
+    ::rl::math::Real* component(const ::std::size_t& b, const ::std::size_t& c) { return &data[(b * 12 + c) * count]; }
+
+    const ::rl::math::Real* component(const ::std::size_t& b, const ::std::size_t& c) const { return &data[(b * 12 + c) * count]; }
+
+    ::std::size_t count;
+
+    ::std::vector< ::rl::math::Real > data;
+
+    ::std::vector< ::rl::math::Real > c;
+
+    ::std::vector< ::rl::math::Real > s;
+  };
+
+  BatchKinematics();
+
+  virtual ~BatchKinematics();
+
+  /** Reads the chain from model, false if it is no 6-DOF chain about z axes, then isValid() is false */
+  bool calibrate(::rl::plan::Model& model);
+
+  bool isValid() const { return valid; }
+
+  /** Frames of u + alphas[k] (v - u) for every k */
+  void compute(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::std::vector< ::rl::math::Real >& alphas, Block& block) const;
+
+  /** Moves the bodies of model to configuration k of block, the kinematics of model is not updated */
+  void apply(const Block& block, const ::std::size_t& k, ::rl::plan::Model& model) const;
+
+  /**
+  *	Index of the first configuration u + alphas[k] (v - u) that collides on
+  *	model, alphas.size() if none does. Checks in alphas order, blockSize
+  *	configurations per kinematics pass, safe to call from several threads
+  *	with one model each. Falls back to the model's kinematics if not valid.
+  */
+  ::std::size_t firstCollision(::rl::plan::SimpleModel* model, const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::std::vector< ::rl::math::Real >& alphas, ::std::size_t& queries) const;
+
+  /** Configurations per kinematics pass in firstCollision() */
+  ::std::size_t blockSize;
+
+  static const ::std::size_t DOF = 6;
+
+  static const ::std::size_t BODIES = DOF + 1;
+
+protected:
+  /** Fixed part of each joint transform, body i + 1 = body i * Rz(q(i)) * joints[i] */
+  ::std::vector< ::rl::math::Transform > joints;
+
+  /** Body 0 in the world */
+  ::rl::math::Transform base;
+
+  /** Tool frame relative to the last body */
+  ::rl::math::Transform tool;
+
+  bool valid;
+
+private:
+
+};
+
+#endif // _BATCH_KINEMATICS_H_
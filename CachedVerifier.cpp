@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+#include <boost/functional/hash.hpp>
+#include <rl/plan/SimpleModel.h>
+
+#include "CachedVerifier.h"
+
+CachedVerifier::CachedVerifier() :
+  Verifier(),
+  verifier(NULL),
+  leafSteps(8),
+  capacity(1 << 18),
+  segments(),
+  cachedDelta(0),
+  statistics()
+{
+}
+
+CachedVerifier::~CachedVerifier()
+{
+}
+
+::std::size_t
+CachedVerifier::SegmentHash::operator()(const Segment& segment) const
+{
+  ::std::size_t seed = ::boost::hash_range(segment.u.data(), segment.u.data() + segment.u.size());
+  ::boost::hash_range(seed, segment.v.data(), segment.v.data() + segment.v.size());
+  return seed;
+}
+
+bool
+CachedVerifier::check(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::rl::math::Real& d, ::std::size_t& queries)
+{
+  ++this->statistics.calls;
+
+  // A segment is the same in both directions
+  Segment segment;
+  bool swapped = ::std::lexicographical_compare(v.data(), v.data() + v.size(), u.data(), u.data() + u.size());
+  segment.u = swapped ? v : u;
+  segment.v = swapped ? u : v;
+
+  ::std::unordered_map< Segment, Entry, SegmentHash >::const_iterator found = this->segments.find(segment);
+
+  if (this->segments.end() != found)
+  {
+    ++this->statistics.hits;
+    this->statistics.saved += found->second.queries;
+    queries = found->second.queries;
+    return found->second.colliding;
+  }
+
+  Entry entry;
+
+  if (::std::ceil(d / this->verifier->delta) <= this->leafSteps)
+  {
+    ::std::size_t before = this->model->getTotalQueries();
+    entry.colliding = this->verifier->isColliding(u, v, d);
+    entry.queries = this->model->getTotalQueries() - before;
+    this->statistics.queries += entry.queries;
+  }
+  else
+  {
+    // Midpoint first, then both halves, so collisions are found coarse to fine
+    ::rl::math::Vector q(u.size());
+    this->model->interpolate(u, v, 0.5f, q);
+    this->model->setPosition(q);
+    this->model->updateFrames();
+    entry.colliding = this->model->isColliding();
+    entry.queries = 1;
+    ++this->statistics.queries;
+
+    ::std::size_t half = 0;
+
+    if (!entry.colliding)
+    {
+      entry.colliding = this->check(u, q, d / 2, half);
+      entry.queries += half;
+    }
+
+    if (!entry.colliding)
+    {
+      entry.colliding = this->check(q, v, d / 2, half);
+      entry.queries += half;
+    }
+  }
+
+  if (this->segments.size() >= this->capacity)
+  {
+    this->segments.clear();
+  }
+
+  this->segments.insert(::std::make_pair(segment, entry));
+  queries = entry.queries;
+
+  return entry.colliding;
+}
+
+void
+CachedVerifier::clear()
+{
+  this->segments.clear();
+}
+
+bool
+CachedVerifier::isColliding(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::rl::math::Real& d)
+{
+  // Results only hold for the resolution they were computed at
+  if (this->verifier->delta != this->cachedDelta)
+  {
+    this->segments.clear();
+    this->cachedDelta = this->verifier->delta;
+  }
+
+  this->delta = this->verifier->delta;
+  this->model = this->verifier->model;
+
+  ::std::size_t queries = 0;
+  return this->check(u, v, d, queries);
+}
+
+void
+CachedVerifier::resetStatistics()
+{
+  this->statistics = Statistics();
+}
@@ -0,0 +1,82 @@
+#ifndef _CACHED_VERIFIER_H_
+#define _CACHED_VERIFIER_H_
+
+#include <unordered_map>
+#include <rl/plan/Verifier.h>
+
+/**
+*	Remembers which segments were already proven free or colliding.
+*	Long segments are split at their midpoint, so overlapping and nested checks
+*	share their halves, short segments are passed on to the wrapped verifier.
+*	Results are keyed by the exact endpoint pair and only valid for the delta
+*	of the wrapped verifier, the cache is dropped once that changes.
+*/
+class CachedVerifier : public rl::plan::Verifier
+{
+public:
+  struct Statistics
+  {
+    ::std::size_t calls;    // segments checked through the cache, including halves
+    ::std::size_t hits;     // segments answered from memory
+    ::std::size_t queries;  // collision queries issued
+    ::std::size_t saved;    // collision queries the hits would have cost
+  };
+
+  CachedVerifier();
+
+  virtual ~CachedVerifier();
+
+  bool isColliding(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::rl::math::Real& d);
+
+  /** Forgets all segments, required once the scene changes */
+  void clear();
+
+  const Statistics& getStatistics() const { return statistics; }
+
+  void resetStatistics();
+
+  ::std::size_t getSize() const { return segments.size(); }
+
+  /** The wrapped verifier, checks the segments that are not split any further */
+  rl::plan::Verifier* verifier;
+
+  /** Segments with at most this many steps are passed on to verifier */
+  ::std::size_t leafSteps;
+
+  /** Maximum number of cached segments, the cache is dropped once full */
+  ::std::size_t capacity;
+
+protected:
+  struct Segment
+  {
+    ::rl::math::Vector u;
+    ::rl::math::Vector v;
+
+    bool operator==(const Segment& other) const { return u == other.u && v == other.v; }
+  };
+
+  struct SegmentHash
+  {
+    ::std::size_t operator()(const Segment& segment) const;
+  };
+
+  struct Entry
+  {
+    bool colliding;
+    ::std::size_t queries;  // collision queries deciding it costs without the cache
+  };
+
+  /** Checks u-v, queries is what deciding it costs without the cache */
+  bool check(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::rl::math::Real& d, ::std::size_t& queries);
+
+  ::std::unordered_map< Segment, Entry, SegmentHash > segments;
+
+  ::rl::math::Real cachedDelta;
+
+  Statistics statistics;
+
+private:
+
+};
+
+#endif // _CACHED_VERIFIER_H_
@@ -0,0 +1,94 @@
+#include <cmath>
+#include "CollisionIndex.h"
+
+CollisionIndex::CollisionIndex() :
+  radius(0),
+  capacity(4096),
+  cells(),
+  points(),
+  next(0)
+{
+}
+
+CollisionIndex::~CollisionIndex()
+{
+}
+
+void
+CollisionIndex::clear()
+{
+  this->cells.clear();
+  this->points.clear();
+  this->next = 0;
+}
+
+bool
+CollisionIndex::contains(const ::rl::math::Vector& q) const
+{
+  if (this->radius <= 0)
+  {
+    return false;
+  }
+
+  ::std::pair< ::std::unordered_multimap< ::std::uint64_t, ::std::size_t >::const_iterator, ::std::unordered_multimap< ::std::uint64_t, ::std::size_t >::const_iterator > range = this->cells.equal_range(this->key(q));
+
+  for (; range.first != range.second; ++range.first)
+  {
+    if ((this->points[range.first->second] - q).norm() <= this->radius)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void
+CollisionIndex::insert(const ::rl::math::Vector& q)
+{
+  if (this->radius <= 0 || 0 == this->capacity)
+  {
+    return;
+  }
+
+  if (this->points.size() < this->capacity)
+  {
+    this->next = this->points.size();
+    this->points.push_back(q);
+  }
+  else
+  {
+    // Full, drop the oldest configuration from its cell and reuse its slot
+    this->next = (this->next + 1) % this->capacity;
+
+    ::std::pair< ::std::unordered_multimap< ::std::uint64_t, ::std::size_t >::iterator, ::std::unordered_multimap< ::std::uint64_t, ::std::size_t >::iterator > range = this->cells.equal_range(this->key(this->points[this->next]));
+
+    for (; range.first != range.second; ++range.first)
+    {
+      if (this->next == range.first->second)
+      {
+        this->cells.erase(range.first);
+        break;
+      }
+    }
+
+    this->points[this->next] = q;
+  }
+
+  this->cells.insert(::std::make_pair(this->key(q), this->next));
+}
+
+::std::uint64_t
+CollisionIndex::key(const ::rl::math::Vector& q) const
+{
+  // FNV-1a over the cell coordinates
+  ::std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+  for (::std::ptrdiff_t i = 0; i < q.size(); ++i)
+  {
+    hash ^= static_cast< ::std::uint64_t >(static_cast< ::std::int64_t >(::std::floor(q(i) / this->radius)));
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
@@ -0,0 +1,52 @@
+#ifndef _COLLISION_INDEX_H_
+#define _COLLISION_INDEX_H_
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <rl/math/Vector.h>
+
+/**
+*	Bounded index of configurations already known to collide.
+*	Configurations are hashed into a grid with cells of size radius, a query
+*	only compares against the points in its own cell, so it is constant time
+*	and may miss a neighbour across a cell border. Once capacity is reached
+*	the oldest configuration is dropped.
+*/
+class CollisionIndex
+{
+public:
+  CollisionIndex();
+
+  virtual ~CollisionIndex();
+
+  void insert(const ::rl::math::Vector& q);
+
+  /** True if q lies within radius of a known colliding configuration */
+  bool contains(const ::rl::math::Vector& q) const;
+
+  void clear();
+
+  ::std::size_t getSize() const { return points.size(); }
+
+  /** Configurations closer than this are rejected, also the grid cell size */
+  ::rl::math::Real radius;
+
+  /** Maximum number of configurations kept */
+  ::std::size_t capacity;
+
+protected:
+  ::std::uint64_t key(const ::rl::math::Vector& q) const;
+
+  ::std::unordered_multimap< ::std::uint64_t, ::std::size_t > cells;
+
+  /** Ring buffer of the kept configurations */
+  ::std::vector< ::rl::math::Vector > points;
+
+  ::std::size_t next;
+
+private:
+
+};
+
+#endif // _COLLISION_INDEX_H_
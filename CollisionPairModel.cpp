@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <rl/sg/bullet/Shape.h>
+
+#include "CollisionPairModel.h"
+
+CollisionPairModel::CollisionPairModel() :
+  DistanceModel(),
+  reorderInterval(256),
+  pairs(),
+  bodies(),
+  simpleScene(NULL),
+  candidatePairs(0),
+  queriesSinceReorder(0)
+{
+}
+
+CollisionPairModel::~CollisionPairModel()
+{
+}
+
+void
+CollisionPairModel::clearPairs()
+{
+  this->pairs.clear();
+  this->bodies.clear();
+  this->candidatePairs = 0;
+  this->queriesSinceReorder = 0;
+}
+
+void
+CollisionPairModel::copyPairs(const CollisionPairModel& other)
+{
+  this->pairs = other.pairs;
+  this->candidatePairs = other.candidatePairs;
+  this->queriesSinceReorder = 0;
+  this->resolvePairs();
+}
+
+void
+CollisionPairModel::filterPairs(const ::std::size_t& samples, const ::std::mt19937::result_type& seed)
+{
+  ::std::size_t robot = 0;
+
+  while (this->scene->getModel(robot) != this->model)
+  {
+    ++robot;
+  }
+
+  // Every robot body against every other body of the scene, self pairs as the kinematics allows
+  ::std::vector< Pair > candidates;
+
+  for (::std::size_t i = 0; i < this->model->getNumBodies(); ++i)
+  {
+    for (::std::size_t j = 0; j < this->scene->getNumModels(); ++j)
+    {
+      if (j == robot)
+      {
+        continue;
+      }
+
+      for (::std::size_t k = 0; k < this->scene->getModel(j)->getNumBodies(); ++k)
+      {
+        Pair pair = {robot, i, j, k, 0, 0};
+        candidates.push_back(pair);
+      }
+    }
+
+    for (::std::size_t j = i + 1; j < this->model->getNumBodies(); ++j)
+    {
+      if (this->kin->isColliding(i, j))
+      {
+        Pair pair = {robot, i, robot, j, 0, 0};
+        candidates.push_back(pair);
+      }
+    }
+  }
+
+  this->candidatePairs = candidates.size();
+  this->pairs = candidates;
+  this->resolvePairs();
+
+  if (0 == samples)
+  {
+    return;
+  }
+
+  // Random configurations: which pairs ever touch, which robot bodies ever move,
+  // and whether the distance between consecutive body origins is fixed
+  ::std::mt19937 engine(seed);
+  ::std::uniform_real_distribution< ::rl::math::Real > distribution(0, 1);
+  ::rl::math::Vector minimum = this->getMinimum();
+  ::rl::math::Vector maximum = this->getMaximum();
+  ::rl::math::Vector q(this->getDof());
+
+  ::std::vector< bool > touched(this->pairs.size(), false);
+  ::std::vector< bool > moving(this->model->getNumBodies(), false);
+  ::std::vector< ::rl::math::Transform > frames(this->model->getNumBodies());
+  ::std::vector< ::rl::math::Real > links(this->model->getNumBodies(), 0);
+  ::std::vector< bool > rigid(this->model->getNumBodies(), true);
+
+  for (::std::size_t n = 0; n < samples; ++n)
+  {
+    for (::std::size_t i = 0; i < this->getDof(); ++i)
+    {
+      q(i) = minimum(i) + distribution(engine) * (maximum(i) - minimum(i));
+    }
+
+    this->setPosition(q);
+    this->updateFrames();
+
+    for (::std::size_t i = 0; i < this->model->getNumBodies(); ++i)
+    {
+      ::rl::math::Transform frame;
+      this->model->getBody(i)->getFrame(frame);
+      moving[i] = moving[i] || (n > 0 && !frame.isApprox(frames[i]));
+      frames[i] = frame;
+    }
+
+    for (::std::size_t i = 1; i < this->model->getNumBodies(); ++i)
+    {
+      ::rl::math::Real link = (frames[i].translation() - frames[i - 1].translation()).norm();
+      rigid[i] = rigid[i] && (0 == n || ::std::abs(link - links[i]) <= 1.0e-6f * (1 + links[i]));
+      links[i] = link;
+    }
+
+    for (::std::size_t i = 0; i < this->pairs.size(); ++i)
+    {
+      touched[i] = touched[i] || this->simpleScene->areColliding(this->bodies[i].first, this->bodies[i].second);
+    }
+  }
+
+  // Workspace reach of every robot body around the origin of the fixed base: the
+  // distances between consecutive body origins are fixed, as for revolute DH joints,
+  // so a body stays within their sum plus its own bounding radius. Infinite if not.
+  ::std::vector< ::rl::math::Real > reach(this->model->getNumBodies(), ::std::numeric_limits< ::rl::math::Real >::infinity());
+  ::rl::math::Real chain = 0;
+
+  for (::std::size_t i = 0; i < this->model->getNumBodies() && !moving[0]; ++i)
+  {
+    if (i > 0 && !rigid[i])
+    {
+      break;
+    }
+
+    chain += 0 == i ? 0 : links[i];
+    ::rl::math::Vector3 center;
+    ::rl::math::Real radius = this->getBoundingSphere(this->model->getBody(i), ::rl::math::Transform::Identity(), center);
+    reach[i] = chain + center.norm() + radius;
+  }
+
+  // Only pairs that provably never meet are dropped: robot bodies that do not
+  // move and are apart from the scene once, and scene bodies out of a body's
+  // reach. Pairs that never touched in the samples stay, tested last.
+  ::std::vector< Pair > kept;
+  ::std::vector< Pair > untouched;
+
+  for (::std::size_t i = 0; i < this->pairs.size(); ++i)
+  {
+    const Pair& pair = this->pairs[i];
+    bool self = pair.firstModel == pair.secondModel;
+    bool fixed = !moving[pair.firstBody] && (!self || !moving[pair.secondBody]);
+
+    if (fixed && !touched[i])
+    {
+      continue;
+    }
+
+    if (!self)
+    {
+      ::rl::math::Transform frame;
+      this->bodies[i].second->getFrame(frame);
+      ::rl::math::Vector3 center;
+      ::rl::math::Real radius = this->getBoundingSphere(this->bodies[i].second, frame, center);
+
+      if ((center - frames[0].translation()).norm() > reach[pair.firstBody] + radius)
+      {
+        continue;
+      }
+    }
+
+    (touched[i] ? kept : untouched).push_back(pair);
+  }
+
+  kept.insert(kept.end(), untouched.begin(), untouched.end());
+  this->pairs = kept;
+  this->resolvePairs();
+}
+
+::std::string
+CollisionPairModel::getBodyName(const ::std::size_t& model, const ::std::size_t& body) const
+{
+  ::std::ostringstream name;
+  name << this->scene->getModel(model)->getName() << "[" << body << "]";
+  return name.str();
+}
+
+bool
+CollisionPairModel::isColliding()
+{
+  if (this->pairs.empty() && 0 == this->candidatePairs)
+  {
+    // Not filtered yet, fall back to the full pair set
+    return DistanceModel::isColliding();
+  }
+
+  ++this->totalQueries;
+
+  if (++this->queriesSinceReorder >= this->reorderInterval)
+  {
+    this->reorderPairs();
+  }
+
+  for (::std::size_t i = 0; i < this->pairs.size(); ++i)
+  {
+    ++this->pairs[i].checks;
+
+    if (this->simpleScene->areColliding(this->bodies[i].first, this->bodies[i].second))
+    {
+      ++this->pairs[i].collisions;
+      return true;
+    }
+  }
+
+  ++this->freeQueries;
+  return false;
+}
+
+void
+CollisionPairModel::reorderPairs()
+{
+  this->queriesSinceReorder = 0;
+
+  // Stable, so pairs without collisions keep the robot-to-scene order from the base outwards
+  ::std::stable_sort(this->pairs.begin(), this->pairs.end(), [](const Pair& a, const Pair& b) {
+    return a.collisions > b.collisions;
+  });
+
+  this->resolvePairs();
+}
+
+void
+CollisionPairModel::resolvePairs()
+{
+  this->simpleScene = dynamic_cast< ::rl::sg::SimpleScene* >(this->scene);
+  this->bodies.resize(this->pairs.size());
+
+  for (::std::size_t i = 0; i < this->pairs.size(); ++i)
+  {
+    this->bodies[i].first = this->scene->getModel(this->pairs[i].firstModel)->getBody(this->pairs[i].firstBody);
+    this->bodies[i].second = this->scene->getModel(this->pairs[i].secondModel)->getBody(this->pairs[i].secondBody);
+  }
+}
+
+::rl::math::Real
+CollisionPairModel::getBoundingSphere(::rl::sg::Body* body, const ::rl::math::Transform& frame, ::rl::math::Vector3& center) const
+{
+  // Union of the bounding spheres of the shapes, around the first shape's center
+  ::std::vector< ::rl::math::Vector3 > centers;
+  ::std::vector< ::rl::math::Real > radii;
+
+  for (::std::size_t i = 0; i < body->getNumShapes(); ++i)
+  {
+    ::rl::sg::bullet::Shape* shape = static_cast< ::rl::sg::bullet::Shape* >(body->getShape(i));
+    btVector3 local;
+    btScalar radius;
+    shape->shape->getBoundingSphere(local, radius);
+
+    ::rl::math::Transform transform;
+    shape->getTransform(transform);
+    centers.push_back(frame * transform * ::rl::math::Vector3(local.x(), local.y(), local.z()));
+    radii.push_back(radius);
+  }
+
+  if (centers.empty())
+  {
+    center = frame.translation();
+    return 0;
+  }
+
+  center = centers[0];
+  ::rl::math::Real radius = 0;
+
+  for (::std::size_t i = 0; i < centers.size(); ++i)
+  {
+    radius = ::std::max(radius, (centers[i] - center).norm() + radii[i]);
+  }
+
+  return radius;
+}
@@ -0,0 +1,88 @@
+#ifndef _COLLISION_PAIR_MODEL_H_
+#define _COLLISION_PAIR_MODEL_H_
+
+#include <random>
+#include <string>
+#include <vector>
+#include <rl/plan/DistanceModel.h>
+#include <rl/sg/SimpleScene.h>
+
+/**
+*	DistanceModel that checks its body pairs one by one instead of the full set.
+*	filterPairs() drops the pairs that provably never collide: self-collision
+*	pairs the kinematics ignores, robot bodies that do not move against the
+*	scene when they are apart once, and scene bodies out of a robot body's
+*	reach. Pairs that never touched in a set of random configurations are
+*	kept but tested last. The pairs are tested most frequently colliding
+*	first, so a colliding configuration usually stops after one pair test.
+*/
+class CollisionPairModel : public rl::plan::DistanceModel
+{
+public:
+  struct Pair
+  {
+    ::std::size_t firstModel;   // scene model index of the first body
+    ::std::size_t firstBody;
+    ::std::size_t secondModel;  // scene model index of the second body
+    ::std::size_t secondBody;
+    ::std::size_t checks;       // tests of this pair
+    ::std::size_t collisions;   // tests that found a collision
+  };
+
+  CollisionPairModel();
+
+  virtual ~CollisionPairModel();
+
+  virtual bool isColliding();
+
+  /**
+  *	Builds the pair set of the loaded scene and drops the pairs that can never
+  *	collide, ordering the pairs that never collided in samples random
+  *	configurations last. samples = 0 keeps every pair the kinematics allows.
+  *	The model is left at an arbitrary configuration.
+  */
+  void filterPairs(const ::std::size_t& samples, const ::std::mt19937::result_type& seed = 0);
+
+  /** Drops the pair set, isColliding() checks the full scene again */
+  void clearPairs();
+
+  /** Takes the pairs and their statistics from other, a model of the same scene */
+  void copyPairs(const CollisionPairModel& other);
+
+  /** Active pairs in test order */
+  const ::std::vector< Pair >& getPairs() const { return pairs; }
+
+  /** Number of pairs before filtering */
+  ::std::size_t getCandidatePairs() const { return candidatePairs; }
+
+  /** Name of a body in the scene as model[body] */
+  ::std::string getBodyName(const ::std::size_t& model, const ::std::size_t& body) const;
+
+  /** Radius of a sphere around center that encloses the shapes of body at frame */
+  ::rl::math::Real getBoundingSphere(::rl::sg::Body* body, const ::rl::math::Transform& frame, ::rl::math::Vector3& center) const;
+
+  /** Queries between two reorderings of the pairs */
+  ::std::size_t reorderInterval;
+
+protected:
+  /** Resolves the body pointers of pairs for this model's scene */
+  void resolvePairs();
+
+  /** Sorts the pairs by collisions, most frequent first */
+  void reorderPairs();
+
+  ::std::vector< Pair > pairs;
+
+  ::std::vector< ::std::pair< ::rl::sg::Body*, ::rl::sg::Body* > > bodies;
+
+  ::rl::sg::SimpleScene* simpleScene;
+
+  ::std::size_t candidatePairs;
+
+  ::std::size_t queriesSinceReorder;
+
+private:
+
+};
+
+#endif // _COLLISION_PAIR_MODEL_H_
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <rl/sg/DistanceScene.h>
+
+#include "ContinuousVerifier.h"
+#include "PhaseProfiler.h"
+
+ContinuousVerifier::ContinuousVerifier() :
+  Verifier(),
+  radii(),
+  tolerance(1.0e-3f),
+  maxSteps(1000),
+  statistics()
+{
+}
+
+ContinuousVerifier::~ContinuousVerifier()
+{
+}
+
+bool
+ContinuousVerifier::advance(rl::plan::SimpleModel* model, const ::rl::math::Vector& u, const ::rl::math::Vector& v, ::rl::math::Real& contact, ::std::size_t& queries) const
+{
+  // Upper bound of the distance any point of the robot travels from u to v
+  ::rl::math::Real bound = 0;
+
+  for (::std::ptrdiff_t i = 0; i < u.size(); ++i)
+  {
+    bound += this->radii(i) * ::std::abs(v(i) - u(i));
+  }
+
+  ::rl::math::Vector q(u.size());
+  ::rl::math::Real alpha = 0;
+
+  for (::std::size_t step = 0; step < this->maxSteps; ++step)
+  {
+    model->interpolate(u, v, alpha, q);
+    model->setPosition(q);
+    {
+      PROFILE_SCOPE(KINEMATICS);
+      model->updateFrames();
+    }
+    ++queries;
+
+    ::rl::math::Real distance = this->clearance(model);
+
+    if (distance <= this->tolerance)
+    {
+      contact = alpha;
+      return false;
+    }
+
+    // Nothing can be reached before the robot has moved distance
+    if (bound <= 0 || alpha + distance / bound >= 1)
+    {
+      return true;
+    }
+
+    alpha += distance / bound;
+  }
+
+  // Grazing an obstacle for maxSteps steps, the rest is checked every delta
+  ::rl::math::Vector w(u.size());
+  model->interpolate(u, v, alpha, w);
+  ::std::size_t steps = static_cast< ::std::size_t >(::std::ceil(model->distance(w, v) / this->delta));
+
+  for (::std::size_t step = 1; step <= steps; ++step)
+  {
+    ::rl::math::Real beta = static_cast< ::rl::math::Real >(step) / steps;
+    model->interpolate(w, v, beta, q);
+    model->setPosition(q);
+    {
+      PROFILE_SCOPE(KINEMATICS);
+      model->updateFrames();
+    }
+    ++queries;
+
+    if (model->isColliding())
+    {
+      contact = alpha + beta * (1 - alpha);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+ContinuousVerifier::calibrate(CollisionPairModel& model)
+{
+  this->radii.resize(0);
+
+  const ::std::size_t dof = model.getDof();
+
+  if (dof + 1 != model.model->getNumBodies())
+  {
+    return false;
+  }
+
+  // Distances between consecutive body origins and the bounding spheres of the bodies
+  ::rl::math::Vector q = ::rl::math::Vector::Zero(dof);
+  model.setPosition(q);
+  model.updateFrames();
+
+  ::std::vector< ::rl::math::Real > links(dof + 1, 0);
+  ::std::vector< ::rl::math::Vector3 > centers(dof + 1);
+  ::std::vector< ::rl::math::Real > spheres(dof + 1, 0);
+
+  for (::std::size_t j = 0; j <= dof; ++j)
+  {
+    ::rl::math::Transform frame;
+    model.model->getBody(j)->getFrame(frame);
+    spheres[j] = model.getBoundingSphere(model.model->getBody(j), ::rl::math::Transform::Identity(), centers[j]);
+
+    if (j > 0)
+    {
+      ::rl::math::Transform previous;
+      model.model->getBody(j - 1)->getFrame(previous);
+      links[j] = (frame.translation() - previous.translation()).norm();
+    }
+  }
+
+  // Joint i turns bodies i + 1 and up, none of them is farther from the origin of body i
+  // than the chain of body origins up to it plus its own bounding sphere
+  ::rl::math::Vector radii = ::rl::math::Vector::Zero(dof);
+
+  for (::std::size_t i = 0; i < dof; ++i)
+  {
+    ::rl::math::Real chain = 0;
+
+    for (::std::size_t j = i + 1; j <= dof; ++j)
+    {
+      chain += links[j];
+      radii(i) = ::std::max(radii(i), chain + centers[j].norm() + spheres[j]);
+    }
+  }
+
+  // Small motions of one joint at random configurations: the bodies before it stay,
+  // the body origins and sphere centers after it move no more than the bound
+  ::std::mt19937 engine(0);
+  ::std::uniform_real_distribution< ::rl::math::Real > distribution(0, 1);
+  ::rl::math::Vector minimum = model.getMinimum();
+  ::rl::math::Vector maximum = model.getMaximum();
+  const ::rl::math::Real epsilon = 1.0e-3f;
+  ::std::vector< ::rl::math::Vector3 > before(2 * (dof + 1));
+  ::std::vector< ::rl::math::Vector3 > after(2 * (dof + 1));
+
+  for (::std::size_t n = 0; n < 100; ++n)
+  {
+    for (::std::size_t i = 0; i < dof; ++i)
+    {
+      q(i) = minimum(i) + distribution(engine) * (maximum(i) - minimum(i) - epsilon);
+    }
+
+    for (::std::size_t i = 0; i < dof; ++i)
+    {
+      for (::std::size_t k = 0; k < 2; ++k)
+      {
+        ::rl::math::Vector p = q;
+        p(i) += k * epsilon;
+        model.setPosition(p);
+        model.updateFrames();
+
+        for (::std::size_t j = 0; j <= dof; ++j)
+        {
+          ::rl::math::Transform frame;
+          model.model->getBody(j)->getFrame(frame);
+          (0 == k ? before : after)[2 * j] = frame.translation();
+          (0 == k ? before : after)[2 * j + 1] = frame * centers[j];
+        }
+      }
+
+      for (::std::size_t j = 0; j < before.size(); ++j)
+      {
+        ::rl::math::Real moved = (after[j] - before[j]).norm();
+
+        if (j / 2 <= i ? moved > 1.0e-9f : moved > radii(i) * epsilon * (1 + 1.0e-3f))
+        {
+          return false;
+        }
+      }
+    }
+  }
+
+  this->radii = radii;
+  return true;
+}
+
+::rl::math::Real
+ContinuousVerifier::clearance(rl::plan::SimpleModel* model) const
+{
+  ::rl::sg::DistanceScene* scene = dynamic_cast< ::rl::sg::DistanceScene* >(model->scene);
+  ::rl::math::Real distance = ::std::numeric_limits< ::rl::math::Real >::max();
+  ::rl::math::Vector3 point1;
+  ::rl::math::Vector3 point2;
+
+  for (::std::size_t i = 0; i < model->model->getNumBodies(); ++i)
+  {
+    for (::std::size_t j = 0; j < model->scene->getNumModels(); ++j)
+    {
+      if (model->scene->getModel(j) == model->model)
+      {
+        continue;
+      }
+
+      for (::std::size_t k = 0; k < model->scene->getModel(j)->getNumBodies(); ++k)
+      {
+        distance = ::std::min(distance, scene->distance(model->model->getBody(i), model->scene->getModel(j)->getBody(k), point1, point2));
+      }
+    }
+
+    // Two bodies of the robot can approach each other from both sides
+    for (::std::size_t j = i + 1; j < model->model->getNumBodies(); ++j)
+    {
+      if (model->kin->isColliding(i, j))
+      {
+        distance = ::std::min(distance, scene->distance(model->model->getBody(i), model->model->getBody(j), point1, point2) / 2);
+      }
+    }
+
+    if (distance <= this->tolerance)
+    {
+      break;
+    }
+  }
+
+  return distance;
+}
+
+bool
+ContinuousVerifier::isColliding(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::rl::math::Real& d)
+{
+  ::rl::math::Real contact = 0;
+  ::std::size_t queries = 0;
+  bool free = this->advance(this->model, u, v, contact, queries);
+
+  ++this->statistics.segments;
+  this->statistics.queries += queries;
+  this->statistics.contacts += free ? 0 : 1;
+
+  return !free;
+}
+
+void
+ContinuousVerifier::resetStatistics()
+{
+  this->statistics = Statistics();
+}
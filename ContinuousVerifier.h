@@ -0,0 +1,75 @@
+#ifndef _CONTINUOUS_VERIFIER_H_
+#define _CONTINUOUS_VERIFIER_H_
+
+#include <rl/plan/SimpleModel.h>
+#include <rl/plan/Verifier.h>
+
+#include "CollisionPairModel.h"
+
+/**
+*	Checks a whole joint-space segment by conservative advancement instead of
+*	fixed steps. At every configuration the distance of each robot body to the
+*	scene gives how far the robot can move before it could touch anything,
+*	radii bounds how far any point of the robot moves per radian of a joint,
+*	so the next configuration is as far along the segment as that distance
+*	allows. Free space is crossed in a few large steps and no obstacle can be
+*	skipped, however thin. A segment still grazing an obstacle after maxSteps
+*	advancements is finished in delta steps. The scene of the model must be a
+*	DistanceScene.
+*/
+class ContinuousVerifier : public rl::plan::Verifier
+{
+public:
+  struct Statistics
+  {
+    ::std::size_t segments;   // segments checked
+    ::std::size_t queries;    // distance evaluations, one per advancement step
+    ::std::size_t contacts;   // segments that ended in a contact
+  };
+
+  ContinuousVerifier();
+
+  virtual ~ContinuousVerifier();
+
+  /**
+  *	Derives radii from the kinematics and the body geometry of model: a serial
+  *	chain of revolute joints where joint i turns bodies i + 1 and up about an
+  *	axis through the origin of body i. The bound is checked against random
+  *	joint motions, if the model is no such chain radii is left empty and
+  *	false is returned.
+  */
+  bool calibrate(CollisionPairModel& model);
+
+  bool isColliding(const ::rl::math::Vector& u, const ::rl::math::Vector& v, const ::rl::math::Real& d);
+
+  /**
+  *	Advances from u towards v on model, safe to call from several threads with
+  *	one model each. Returns true if u-v is free, otherwise contact is the
+  *	interpolation parameter of the first contact, everything before it is free.
+  */
+  bool advance(rl::plan::SimpleModel* model, const ::rl::math::Vector& u, const ::rl::math::Vector& v, ::rl::math::Real& contact, ::std::size_t& queries) const;
+
+  const Statistics& getStatistics() const { return statistics; }
+
+  void resetStatistics();
+
+  /** Per joint, the farthest any point of the bodies it moves can be from its axis [m] */
+  ::rl::math::Vector radii;
+
+  /** Distances up to this count as contact [m] */
+  ::rl::math::Real tolerance;
+
+  /** Advancement steps before a segment is given up as colliding */
+  ::std::size_t maxSteps;
+
+protected:
+  /** Smallest distance of the robot to the scene and, halved, to itself at the current frames */
+  ::rl::math::Real clearance(rl::plan::SimpleModel* model) const;
+
+  Statistics statistics;
+
+private:
+
+};
+
+#endif // _CONTINUOUS_VERIFIER_H_
@@ -0,0 +1,304 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "EventTracer.h"
+
+::std::atomic< bool > EventTracer::enabled(false);
+
+::std::chrono::steady_clock::time_point EventTracer::origin;
+
+::std::mutex EventTracer::mutex;
+
+::std::vector< ::std::shared_ptr< EventTracer::Buffer > > EventTracer::buffers;
+
+EventTracer::Span::Span(const char* category, const char* name) :
+  category(category),
+  name(name),
+  begin(isEnabled() ? now() : 0),
+  latency(-1),
+  id(0)
+{
+}
+
+EventTracer::Span::~Span()
+{
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  ::std::uint64_t end = now();
+
+  if (0 != this->id)
+  {
+    Event flow = {"queued", "queued", 'f', this->begin, 0, this->id, -1};
+    record(flow);
+  }
+
+  Event event = {this->category, this->name, 'X', this->begin, end - this->begin, 0, this->latency};
+  record(event);
+}
+
+void
+EventTracer::Span::setQueued(const ::std::uint64_t& posted, const ::std::uint64_t& id)
+{
+  this->latency = this->begin > posted ? this->begin - posted : 0;
+  this->id = id;
+}
+
+const ::std::size_t EventTracer::Channel::LANES;
+
+const ::std::size_t EventTracer::Channel::CAPACITY;
+
+EventTracer::Channel::Channel() :
+  lanes(new Lane[LANES])
+{
+  for (::std::size_t i = 0; i < LANES; ++i)
+  {
+    this->lanes[i].posted = 0;
+    this->lanes[i].received = 0;
+
+    for (::std::size_t j = 0; j < CAPACITY; ++j)
+    {
+      this->lanes[i].entries[j].sequence = ~::std::uint64_t(0);
+      this->lanes[i].entries[j].timestamp = 0;
+    }
+  }
+}
+
+void
+EventTracer::Channel::post(const ::std::size_t& lane)
+{
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  Lane& l = this->lanes[lane];
+  ::std::uint64_t sequence = l.posted.load(::std::memory_order_relaxed);
+  Entry& entry = l.entries[sequence % CAPACITY];
+  ::std::uint64_t timestamp = now();
+
+  // Seqlock, a reader that overlaps the overwrite sees the sequence change
+  entry.sequence.store(~::std::uint64_t(0), ::std::memory_order_relaxed);
+  ::std::atomic_thread_fence(::std::memory_order_release);
+  entry.timestamp.store(timestamp, ::std::memory_order_relaxed);
+  entry.sequence.store(sequence, ::std::memory_order_release);
+  l.posted.store(sequence + 1, ::std::memory_order_release);
+
+  Event flow = {"queued", "queued", 's', timestamp, 0, (static_cast< ::std::uint64_t >(lane + 1) << 48) | (sequence + 1), -1};
+  record(flow);
+}
+
+bool
+EventTracer::Channel::receive(const ::std::size_t& lane, ::std::uint64_t& posted, ::std::uint64_t& id)
+{
+  if (!isEnabled())
+  {
+    return false;
+  }
+
+  Lane& l = this->lanes[lane];
+  ::std::uint64_t sequence = l.received.load(::std::memory_order_relaxed);
+
+  if (sequence >= l.posted.load(::std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  l.received.store(sequence + 1, ::std::memory_order_relaxed);
+
+  Entry& entry = l.entries[sequence % CAPACITY];
+  ::std::uint64_t before = entry.sequence.load(::std::memory_order_acquire);
+  posted = entry.timestamp.load(::std::memory_order_relaxed);
+  ::std::atomic_thread_fence(::std::memory_order_acquire);
+  ::std::uint64_t after = entry.sequence.load(::std::memory_order_relaxed);
+
+  if (before != sequence || after != sequence)
+  {
+    return false;
+  }
+
+  id = (static_cast< ::std::uint64_t >(lane + 1) << 48) | (sequence + 1);
+
+  return true;
+}
+
+EventTracer::Chunk::Chunk() :
+  size(0),
+  next(NULL)
+{
+}
+
+EventTracer::Buffer::Buffer() :
+  head(new Chunk()),
+  tail(head),
+  thread(0),
+  name(NULL)
+{
+}
+
+EventTracer::Buffer::~Buffer()
+{
+  while (NULL != this->head)
+  {
+    Chunk* next = this->head->next.load(::std::memory_order_relaxed);
+    delete this->head;
+    this->head = next;
+  }
+}
+
+void
+EventTracer::instant(const char* category, const char* name)
+{
+  if (!isEnabled())
+  {
+    return;
+  }
+
+  Event event = {category, name, 'i', now(), 0, 0, -1};
+  record(event);
+}
+
+EventTracer::Buffer&
+EventTracer::local()
+{
+  static thread_local ::std::shared_ptr< Buffer > buffer;
+
+  if (!buffer)
+  {
+    buffer = ::std::make_shared< Buffer >();
+    ::std::lock_guard< ::std::mutex > lock(mutex);
+    buffer->thread = buffers.size() + 1;
+    buffers.push_back(buffer);
+  }
+
+  return *buffer;
+}
+
+::std::uint64_t
+EventTracer::now()
+{
+  return ::std::chrono::duration_cast< ::std::chrono::nanoseconds >(::std::chrono::steady_clock::now() - origin).count();
+}
+
+void
+EventTracer::record(const Event& event)
+{
+  Buffer& buffer = local();
+  Chunk* chunk = buffer.tail;
+  ::std::size_t size = chunk->size.load(::std::memory_order_relaxed);
+
+  if (Chunk::SIZE == size)
+  {
+    // Linked before it is used, write() may already follow it
+    Chunk* next = new Chunk();
+    chunk->next.store(next, ::std::memory_order_release);
+    buffer.tail = next;
+    chunk = next;
+    size = 0;
+  }
+
+  chunk->events[size] = event;
+  chunk->size.store(size + 1, ::std::memory_order_release);
+}
+
+void
+EventTracer::setThreadName(const char* name)
+{
+  local().name.store(name, ::std::memory_order_relaxed);
+}
+
+void
+EventTracer::start()
+{
+  // Call before the threads to trace are started
+  origin = ::std::chrono::steady_clock::now();
+  enabled.store(true, ::std::memory_order_release);
+}
+
+bool
+EventTracer::write(const ::std::string& filename)
+{
+  ::std::ofstream file(filename.c_str(), ::std::ios::trunc);
+
+  if (!file)
+  {
+    std::cout << "EventTracer: cannot write " << filename << std::endl;
+    return false;
+  }
+
+  ::std::vector< ::std::shared_ptr< Buffer > > buffers;
+
+  {
+    ::std::lock_guard< ::std::mutex > lock(mutex);
+    buffers = EventTracer::buffers;
+  }
+
+  ::std::size_t count = 0;
+  file << ::std::fixed << ::std::setprecision(3);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << ::std::endl;
+
+  for (::std::size_t i = 0; i < buffers.size(); ++i)
+  {
+    const char* name = buffers[i]->name.load(::std::memory_order_relaxed);
+    file << (count++ > 0 ? ",\n" : "");
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffers[i]->thread << ",\"args\":{\"name\":\"";
+
+    if (NULL != name)
+    {
+      file << name;
+    }
+    else
+    {
+      file << "thread " << buffers[i]->thread;
+    }
+
+    file << "\"}}";
+
+    for (Chunk* chunk = buffers[i]->head; NULL != chunk; chunk = chunk->next.load(::std::memory_order_acquire))
+    {
+      ::std::size_t size = chunk->size.load(::std::memory_order_acquire);
+
+      for (::std::size_t j = 0; j < size; ++j)
+      {
+        const Event& event = chunk->events[j];
+        file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase << "\"";
+        file << ",\"pid\":1,\"tid\":" << buffers[i]->thread << ",\"ts\":" << event.timestamp / 1.0e3;
+
+        switch (event.phase)
+        {
+        case 'X':
+          file << ",\"dur\":" << event.duration / 1.0e3;
+
+          if (event.latency >= 0)
+          {
+            file << ",\"args\":{\"latency_us\":" << event.latency / 1.0e3 << "}";
+          }
+          break;
+        case 'f':
+          file << ",\"bp\":\"e\",\"id\":" << event.id;
+          break;
+        case 's':
+          file << ",\"id\":" << event.id;
+          break;
+        case 'i':
+          file << ",\"s\":\"t\"";
+          break;
+        default:
+          break;
+        }
+
+        file << "}";
+        ++count;
+      }
+    }
+  }
+
+  file << ::std::endl << "]}" << ::std::endl;
+
+  std::cout << "trace: " << count << " events of " << buffers.size() << " threads written to " << filename << std::endl;
+
+  return file.good();
+}
@@ -0,0 +1,155 @@
+#ifndef _EVENT_TRACER_H_
+#define _EVENT_TRACER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+*	Timeline of spans on every thread, written as trace-event JSON that
+*	chrome://tracing and ui.perfetto.dev open. Off until start() is called,
+*	a span then costs one relaxed load.
+*
+*	Every thread appends to its own buffer, a list of fixed chunks that only
+*	it writes and publishes with a release store, so recording never locks.
+*	write() reads the published events of all threads at the end of the run.
+*	Names and categories must be string literals, only the pointers are kept.
+*/
+class EventTracer
+{
+public:
+  /** Span of one scope, with the latency of the queued call that started it if any */
+  class Span
+  {
+  public:
+    Span(const char* category, const char* name);
+
+    ~Span();
+
+    /** Links the span to the post() it was queued by */
+    void setQueued(const ::std::uint64_t& posted, const ::std::uint64_t& id);
+
+  private:
+    const char* category;
+
+    const char* name;
+
+    ::std::uint64_t begin;
+
+    ::std::int64_t latency;
+
+    ::std::uint64_t id;
+  };
+
+  /**
+  *	Timestamps of queued calls from one thread to another, one lane per
+  *	kind of call. The sender posts when it queues a call, the receiver
+  *	takes the timestamps in the same order when the calls arrive, which
+  *	holds for queued Qt signals between the same pair of threads.
+  *	Each lane is a ring, calls that fall a full ring behind get no latency.
+  */
+  class Channel
+  {
+  public:
+    Channel();
+
+    void post(const ::std::size_t& lane);
+
+    /** Timestamp and flow id of the oldest call posted on lane, false if none or overwritten */
+    bool receive(const ::std::size_t& lane, ::std::uint64_t& posted, ::std::uint64_t& id);
+
+    static const ::std::size_t LANES = 16;
+
+    static const ::std::size_t CAPACITY = 4096;
+
+  private:
+    struct Entry
+    {
+      ::std::atomic< ::std::uint64_t > sequence;
+      ::std::atomic< ::std::uint64_t > timestamp;
+    };
+
+    struct Lane
+    {
+      ::std::atomic< ::std::uint64_t > posted;
+      ::std::atomic< ::std::uint64_t > received;
+      Entry entries[CAPACITY];
+    };
+
+    ::std::unique_ptr< Lane[] > lanes;
+  };
+
+  static void start();
+
+  static bool isEnabled() { return enabled.load(::std::memory_order_relaxed); }
+
+  /** Nanoseconds since start() */
+  static ::std::uint64_t now();
+
+  static void instant(const char* category, const char* name);
+
+  /** Track name of the calling thread */
+  static void setThreadName(const char* name);
+
+  /** Writes the events of all threads recorded so far */
+  static bool write(const ::std::string& filename);
+
+private:
+  struct Event
+  {
+    const char* category;
+    const char* name;
+    char phase;
+    ::std::uint64_t timestamp;
+    ::std::uint64_t duration;
+    ::std::uint64_t id;
+    ::std::int64_t latency;
+  };
+
+  struct Chunk
+  {
+    Chunk();
+
+    static const ::std::size_t SIZE = 1024;
+
+    Event events[SIZE];
+
+    ::std::atomic< ::std::size_t > size;
+
+    ::std::atomic< Chunk* > next;
+  };
+
+  struct Buffer
+  {
+    Buffer();
+
+    ~Buffer();
+
+    Chunk* head;
+
+    Chunk* tail;
+
+    ::std::size_t thread;
+
+    ::std::atomic< const char* > name;
+  };
+
+  static void record(const Event& event);
+
+  /** Buffer of the calling thread, registered on first use and kept for write() */
+  static Buffer& local();
+
+  static ::std::atomic< bool > enabled;
+
+  static ::std::chrono::steady_clock::time_point origin;
+
+  static ::std::mutex mutex;
+
+  static ::std::vector< ::std::shared_ptr< Buffer > > buffers;
+};
+
+#endif // _EVENT_TRACER_H_
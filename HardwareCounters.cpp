@@ -0,0 +1,184 @@
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "HardwareCounters.h"
+
+#ifdef __linux__
+namespace
+{
+  int
+  openEvent(const ::std::uint32_t& type, const ::std::uint64_t& config, const int& leader)
+  {
+    perf_event_attr attr;
+    ::std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = -1 == leader ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast< int >(::syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+  }
+}
+#endif
+
+HardwareCounters::HardwareCounters() :
+  fds(),
+  ids(),
+  error()
+{
+  for (::std::size_t i = 0; i < COUNTERS; ++i)
+  {
+    this->fds[i] = -1;
+    this->ids[i] = 0;
+  }
+}
+
+HardwareCounters::~HardwareCounters()
+{
+  this->close();
+}
+
+void
+HardwareCounters::close()
+{
+#ifdef __linux__
+  for (::std::size_t i = COUNTERS; i-- > 0;)
+  {
+    if (-1 != this->fds[i])
+    {
+      ::close(this->fds[i]);
+      this->fds[i] = -1;
+    }
+  }
+#endif
+}
+
+const char*
+HardwareCounters::getName(const Counter& counter)
+{
+  const char* names[] = {"cycles", "instructions", "L1d misses", "LLC misses", "branch misses"};
+  return names[counter];
+}
+
+bool
+HardwareCounters::open()
+{
+  this->close();
+
+#ifdef __linux__
+  const ::std::uint32_t types[] = {
+    PERF_TYPE_HARDWARE,
+    PERF_TYPE_HARDWARE,
+    PERF_TYPE_HW_CACHE,
+    PERF_TYPE_HARDWARE,
+    PERF_TYPE_HARDWARE
+  };
+
+  const ::std::uint64_t configs[] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+  };
+
+  // Cycles lead the group, without them nothing is counted
+  this->fds[CYCLES] = openEvent(types[CYCLES], configs[CYCLES], -1);
+
+  if (-1 == this->fds[CYCLES])
+  {
+    this->error = ::std::strerror(errno);
+
+    if (EACCES == errno || EPERM == errno)
+    {
+      this->error += ", see /proc/sys/kernel/perf_event_paranoid";
+    }
+
+    return false;
+  }
+
+  for (::std::size_t i = CYCLES + 1; i < COUNTERS; ++i)
+  {
+    // A counter the PMU does not offer is left out, the others still count
+    this->fds[i] = openEvent(types[i], configs[i], this->fds[CYCLES]);
+  }
+
+  for (::std::size_t i = 0; i < COUNTERS; ++i)
+  {
+    if (-1 != this->fds[i] && -1 == ::ioctl(this->fds[i], PERF_EVENT_IOC_ID, &this->ids[i]))
+    {
+      ::close(this->fds[i]);
+      this->fds[i] = -1;
+    }
+  }
+
+  if (-1 == this->fds[CYCLES] || -1 == ::ioctl(this->fds[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP))
+  {
+    this->error = ::std::strerror(errno);
+    this->close();
+    return false;
+  }
+
+  return true;
+#else
+  this->error = "perf_event_open needs Linux";
+  return false;
+#endif
+}
+
+bool
+HardwareCounters::read(::std::uint64_t (&values)[COUNTERS]) const
+{
+  for (::std::size_t i = 0; i < COUNTERS; ++i)
+  {
+    values[i] = 0;
+  }
+
+#ifdef __linux__
+  if (!this->isOpen())
+  {
+    return false;
+  }
+
+  // nr, time enabled, time running, then value and id of each member
+  ::std::uint64_t buffer[3 + 2 * COUNTERS];
+
+  if (::read(this->fds[CYCLES], buffer, sizeof(buffer)) < static_cast< ::ssize_t >(3 * sizeof(::std::uint64_t)))
+  {
+    return false;
+  }
+
+  ::std::uint64_t enabled = buffer[1];
+  ::std::uint64_t running = buffer[2];
+
+  if (0 == running)
+  {
+    return false;
+  }
+
+  for (::std::uint64_t i = 0; i < buffer[0] && i < COUNTERS; ++i)
+  {
+    for (::std::size_t j = 0; j < COUNTERS; ++j)
+    {
+      if (-1 != this->fds[j] && this->ids[j] == buffer[3 + 2 * i + 1])
+      {
+        values[j] = running < enabled ? static_cast< ::std::uint64_t >(static_cast< double >(buffer[3 + 2 * i]) * enabled / running) : buffer[3 + 2 * i];
+      }
+    }
+  }
+
+  return true;
+#else
+  return false;
+#endif
+}
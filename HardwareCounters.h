@@ -0,0 +1,61 @@
+#ifndef _HARDWARE_COUNTERS_H_
+#define _HARDWARE_COUNTERS_H_
+
+#include <cstdint>
+#include <string>
+
+/**
+*	Group of hardware performance counters of the calling thread, opened with
+*	perf_event_open and read as one group so all values cover the same span.
+*	User space only, which perf_event_paranoid up to 2 allows. Counters the
+*	CPU or hypervisor does not offer are left out of the group and read as 0,
+*	without perf support (other systems, seccomp, no PMU in the container)
+*	open() fails and getError() tells why.
+*
+*	Every read is a system call, so only phases that take microseconds
+*	should be counted.
+*/
+class HardwareCounters
+{
+public:
+  enum Counter
+  {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    COUNTERS
+  };
+
+  HardwareCounters();
+
+  virtual ~HardwareCounters();
+
+  /** Opens the group for the calling thread, which is the only one it counts */
+  bool open();
+
+  void close();
+
+  /** Current counts, scaled up if the kernel multiplexed the group */
+  bool read(::std::uint64_t (&values)[COUNTERS]) const;
+
+  bool isOpen() const { return -1 != this->fds[CYCLES]; }
+
+  bool isAvailable(const Counter& counter) const { return -1 != this->fds[counter]; }
+
+  const ::std::string& getError() const { return this->error; }
+
+  static const char* getName(const Counter& counter);
+
+protected:
+
+private:
+  int fds[COUNTERS];
+
+  ::std::uint64_t ids[COUNTERS];
+
+  ::std::string error;
+};
+
+#endif // _HARDWARE_COUNTERS_H_
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "JointWeights.h"
+
+::rl::math::Vector
+JointWeights::estimate(::rl::plan::Model& model, ::std::size_t samples, ::std::mt19937::result_type seed)
+{
+  ::std::size_t dof = model.getDof();
+  ::rl::math::Vector minimum = model.getMinimum();
+  ::rl::math::Vector maximum = model.getMaximum();
+
+  ::std::mt19937 engine(seed);
+  ::std::uniform_real_distribution< ::rl::math::Real > distribution(0, 1);
+
+  const ::rl::math::Real h = 0.01f;  // finite difference step [rad]
+
+  ::rl::math::Vector sweep = ::rl::math::Vector::Zero(dof);
+  ::rl::math::Vector q(dof);
+  ::std::vector< ::rl::math::Vector3 > frames(model.getFrames());
+
+  for (::std::size_t n = 0; n < samples; ++n)
+  {
+    for (::std::size_t j = 0; j < dof; ++j)
+    {
+      q(j) = minimum(j) + distribution(engine) * (maximum(j) - minimum(j));
+    }
+
+    model.setPosition(q);
+    model.updateFrames(false);
+
+    for (::std::size_t i = 0; i < frames.size(); ++i)
+    {
+      frames[i] = model.getFrame(i).translation();
+    }
+
+    for (::std::size_t j = 0; j < dof; ++j)
+    {
+      // Step away from the closer joint limit
+      ::rl::math::Vector moved = q;
+      moved(j) += q(j) + h <= maximum(j) ? h : -h;
+
+      model.setPosition(moved);
+      model.updateFrames(false);
+
+      ::rl::math::Real displacement = 0;
+
+      for (::std::size_t i = 0; i < frames.size(); ++i)
+      {
+        displacement = (::std::max)(displacement, (model.getFrame(i).translation() - frames[i]).norm());
+      }
+
+      sweep(j) += displacement / h;
+    }
+  }
+
+  ::rl::math::Vector weights = sweep.array().square();
+  return weights / weights.maxCoeff();
+}
+
+bool
+JointWeights::load(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof, ::rl::math::Vector& weights)
+{
+  ::std::ifstream file(filename.c_str());
+
+  ::std::uint64_t fileHash = 0;
+  ::std::size_t fileDof = 0;
+
+  if (!(file >> fileHash >> fileDof) || fileHash != hash || fileDof != dof)
+  {
+    return false;
+  }
+
+  weights.resize(dof);
+
+  for (::std::size_t j = 0; j < dof; ++j)
+  {
+    if (!(file >> weights(j)))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+JointWeights::save(const ::std::string& filename, ::std::uint64_t hash, const ::rl::math::Vector& weights)
+{
+  ::std::ofstream file(filename.c_str(), ::std::ios::trunc);
+
+  if (!file)
+  {
+    std::cout << "JointWeights: cannot write " << filename << std::endl;
+    return false;
+  }
+
+  file.precision(17);
+  file << hash << " " << weights.size() << std::endl;
+
+  for (::std::ptrdiff_t j = 0; j < weights.size(); ++j)
+  {
+    file << weights(j) << std::endl;
+  }
+
+  return true;
+}
@@ -0,0 +1,31 @@
+#ifndef _JOINT_WEIGHTS_H_
+#define _JOINT_WEIGHTS_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <rl/math/Vector.h>
+#include <rl/plan/Model.h>
+
+/**
+*	Joint weights for YourPlanner's weighted metric, derived from the kinematics.
+*	A joint's sweep is the largest displacement of any frame per radian of that
+*	joint, averaged over random configurations. The weighted metric compares
+*	squared joint distances, so a weight is the squared sweep relative to the
+*	largest one.
+*
+*	File layout (text): kinematics hash, dof, then dof weights.
+*/
+class JointWeights
+{
+public:
+  /** Estimates the weights by finite differences at samples random configurations */
+  static ::rl::math::Vector estimate(::rl::plan::Model& model, ::std::size_t samples, ::std::mt19937::result_type seed = 0);
+
+  /** Reads cached weights, fails if they were computed for another kinematics hash or dof */
+  static bool load(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof, ::rl::math::Vector& weights);
+
+  static bool save(const ::std::string& filename, ::std::uint64_t hash, const ::rl::math::Vector& weights);
+};
+
+#endif // _JOINT_WEIGHTS_H_
@@ -0,0 +1,206 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "OccupancyGrid.h"
+
+namespace
+{
+  const char magic[8] = {'R', 'L', 'O', 'C', 'C', '0', '0', '1'};
+
+  struct Header
+  {
+    char magic[8];
+    ::std::uint64_t hash;
+    ::std::uint32_t dof;
+    ::std::uint32_t reserved;
+    double cellSize;
+    ::std::uint64_t count;
+  };
+}
+
+OccupancyGrid::OccupancyGrid() :
+  cellSize(0.2f),
+  minObservations(3),
+  cells(),
+  mutex()
+{
+}
+
+OccupancyGrid::~OccupancyGrid()
+{
+}
+
+void
+OccupancyGrid::clear()
+{
+  ::std::lock_guard< ::std::mutex > lock(this->mutex);
+  this->cells.clear();
+}
+
+::std::size_t
+OccupancyGrid::getCount(State state) const
+{
+  ::std::lock_guard< ::std::mutex > lock(this->mutex);
+  ::std::size_t count = 0;
+
+  for (::std::unordered_map< ::std::uint64_t, Cell >::const_iterator i = this->cells.begin(); i != this->cells.end(); ++i)
+  {
+    count += state == this->getState(i->second) ? 1 : 0;
+  }
+
+  return count;
+}
+
+OccupancyGrid::State
+OccupancyGrid::getState(const Cell& cell) const
+{
+  if (cell.free > 0)
+  {
+    return cell.colliding > 0 ? State::MIXED : State::FREE;
+  }
+
+  return cell.colliding >= this->minObservations ? State::COLLIDING : State::UNKNOWN;
+}
+
+OccupancyGrid::State
+OccupancyGrid::getState(const ::rl::math::Vector& q) const
+{
+  ::std::uint64_t key = this->key(q);
+  ::std::lock_guard< ::std::mutex > lock(this->mutex);
+  ::std::unordered_map< ::std::uint64_t, Cell >::const_iterator found = this->cells.find(key);
+
+  if (this->cells.end() == found)
+  {
+    return State::UNKNOWN;
+  }
+
+  return this->getState(found->second);
+}
+
+void
+OccupancyGrid::insert(const ::rl::math::Vector& q, bool colliding)
+{
+  ::std::uint64_t key = this->key(q);
+  ::std::lock_guard< ::std::mutex > lock(this->mutex);
+  Cell& cell = this->cells[key];
+
+  if (colliding)
+  {
+    ++cell.colliding;
+  }
+  else
+  {
+    ++cell.free;
+  }
+}
+
+::std::uint64_t
+OccupancyGrid::key(const ::rl::math::Vector& q) const
+{
+  ::std::uint64_t key = 0;
+
+  if (q.size() <= 6)
+  {
+    for (::std::ptrdiff_t i = 0; i < q.size(); ++i)
+    {
+      ::std::int64_t cell = static_cast< ::std::int64_t >(::std::floor(q(i) / this->cellSize)) + 512;
+      key = (key << 10) | (static_cast< ::std::uint64_t >(cell) & 0x3ff);
+    }
+
+    return key;
+  }
+
+  // FNV-1a over the cell coordinates
+  key = 0xcbf29ce484222325ULL;
+
+  for (::std::ptrdiff_t i = 0; i < q.size(); ++i)
+  {
+    key ^= static_cast< ::std::uint64_t >(static_cast< ::std::int64_t >(::std::floor(q(i) / this->cellSize)));
+    key *= 0x100000001b3ULL;
+  }
+
+  return key;
+}
+
+bool
+OccupancyGrid::load(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof)
+{
+  ::std::ifstream file(filename.c_str(), ::std::ios::binary);
+
+  if (!file)
+  {
+    return false;
+  }
+
+  Header header;
+
+  if (!file.read(reinterpret_cast< char* >(&header), sizeof(header)) || 0 != ::std::memcmp(header.magic, magic, sizeof(magic)))
+  {
+    std::cout << "OccupancyGrid: " << filename << " is not an occupancy grid" << std::endl;
+    return false;
+  }
+
+  if (header.hash != hash || header.dof != dof || header.cellSize != this->cellSize)
+  {
+    std::cout << "OccupancyGrid: " << filename << " was built for another scene or cell size" << std::endl;
+    return false;
+  }
+
+  ::std::unordered_map< ::std::uint64_t, Cell > cells;
+  cells.reserve(header.count);
+
+  for (::std::uint64_t i = 0; i < header.count; ++i)
+  {
+    ::std::uint64_t key;
+    Cell cell;
+
+    if (!file.read(reinterpret_cast< char* >(&key), sizeof(key)) ||
+        !file.read(reinterpret_cast< char* >(&cell.free), sizeof(cell.free)) ||
+        !file.read(reinterpret_cast< char* >(&cell.colliding), sizeof(cell.colliding)))
+    {
+      std::cout << "OccupancyGrid: " << filename << " is truncated" << std::endl;
+      return false;
+    }
+
+    cells[key] = cell;
+  }
+
+  ::std::lock_guard< ::std::mutex > lock(this->mutex);
+  this->cells.swap(cells);
+
+  return true;
+}
+
+bool
+OccupancyGrid::save(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof) const
+{
+  ::std::ofstream file(filename.c_str(), ::std::ios::binary | ::std::ios::trunc);
+
+  if (!file)
+  {
+    std::cout << "OccupancyGrid: cannot write " << filename << std::endl;
+    return false;
+  }
+
+  ::std::lock_guard< ::std::mutex > lock(this->mutex);
+
+  Header header;
+  ::std::memcpy(header.magic, magic, sizeof(magic));
+  header.hash = hash;
+  header.dof = static_cast< ::std::uint32_t >(dof);
+  header.reserved = 0;
+  header.cellSize = this->cellSize;
+  header.count = this->cells.size();
+
+  file.write(reinterpret_cast< const char* >(&header), sizeof(header));
+
+  for (::std::unordered_map< ::std::uint64_t, Cell >::const_iterator i = this->cells.begin(); i != this->cells.end(); ++i)
+  {
+    file.write(reinterpret_cast< const char* >(&i->first), sizeof(i->first));
+    file.write(reinterpret_cast< const char* >(&i->second.free), sizeof(i->second.free));
+    file.write(reinterpret_cast< const char* >(&i->second.colliding), sizeof(i->second.colliding));
+  }
+
+  return file.good();
+}
@@ -0,0 +1,81 @@
+#ifndef _OCCUPANCY_GRID_H_
+#define _OCCUPANCY_GRID_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <rl/math/Vector.h>
+
+/**
+*	Sparse grid over the joint space that remembers what collision queries
+*	found in each coarse cell. A cell is colliding once it has seen at least
+*	minObservations colliding configurations and no free one, free once it
+*	has only seen free ones, mixed otherwise. Only observed cells are stored.
+*
+*	File layout: 8 byte magic "RLOCC001", uint64 scene hash, uint32 dof,
+*	uint32 reserved, double cellSize, uint64 count, then count cells of
+*	uint64 key, uint32 free observations, uint32 colliding observations.
+*/
+class OccupancyGrid
+{
+public:
+  enum class State
+  {
+    UNKNOWN,
+    FREE,
+    COLLIDING,
+    MIXED
+  };
+
+  OccupancyGrid();
+
+  virtual ~OccupancyGrid();
+
+  /** Records the result of one collision query at q, safe to call from several threads */
+  void insert(const ::rl::math::Vector& q, bool colliding);
+
+  State getState(const ::rl::math::Vector& q) const;
+
+  /** True if q lies in a cell that is known to collide */
+  bool isColliding(const ::rl::math::Vector& q) const { return State::COLLIDING == this->getState(q); }
+
+  void clear();
+
+  /** Reads a grid, fails if it was built for another scene hash, dof or cell size */
+  bool load(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof);
+
+  bool save(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof) const;
+
+  ::std::size_t getSize() const { return cells.size(); }
+
+  /** Number of cells in each state */
+  ::std::size_t getCount(State state) const;
+
+  /** Edge length of a cell in every joint [rad] */
+  ::rl::math::Real cellSize;
+
+  /** Colliding observations before a cell counts as colliding */
+  ::std::uint32_t minObservations;
+
+protected:
+  struct Cell
+  {
+    ::std::uint32_t free;
+    ::std::uint32_t colliding;
+  };
+
+  /** Packs the cell coordinates, 10 bits per joint, hashed beyond six joints */
+  ::std::uint64_t key(const ::rl::math::Vector& q) const;
+
+  State getState(const Cell& cell) const;
+
+  ::std::unordered_map< ::std::uint64_t, Cell > cells;
+
+  mutable ::std::mutex mutex;
+
+private:
+
+};
+
+#endif // _OCCUPANCY_GRID_H_
@@ -0,0 +1,28 @@
+#include "OccupancyModel.h"
+
+OccupancyModel::OccupancyModel() :
+  TwoTierModel(),
+  grid(NULL),
+  q()
+{
+}
+
+OccupancyModel::~OccupancyModel()
+{
+}
+
+bool
+OccupancyModel::isColliding()
+{
+  bool colliding = TwoTierModel::isColliding();
+
+  if (NULL != this->grid)
+  {
+    // The kinematics holds the position the query was made at
+    this->q.resize(this->kin->getDof());
+    this->kin->getPosition(this->q);
+    this->grid->insert(this->q, colliding);
+  }
+
+  return colliding;
+}
@@ -0,0 +1,29 @@
+#ifndef _OCCUPANCY_MODEL_H_
+#define _OCCUPANCY_MODEL_H_
+
+#include "OccupancyGrid.h"
+#include "TwoTierModel.h"
+
+/**
+*	TwoTierModel that records the result of every collision query in an
+*	OccupancyGrid, so planner and optimizer queries both feed it.
+*/
+class OccupancyModel : public TwoTierModel
+{
+public:
+  OccupancyModel();
+
+  virtual ~OccupancyModel();
+
+  virtual bool isColliding();
+
+  /** The grid to record into, NULL records nothing */
+  OccupancyGrid* grid;
+
+protected:
+
+private:
+  ::rl::math::Vector q;
+};
+
+#endif // _OCCUPANCY_MODEL_H_
@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <thread>
+
+#include "EventTracer.h"
+#include "ParallelShortcutOptimizer.h"
+
+ParallelShortcutOptimizer::ParallelShortcutOptimizer() :
+  Optimizer(),
+  models(),
+  candidates(64),
+  rounds(200),
+  patience(10),
+  delta(1.0f),
+  batch(),
+  continuous(NULL),
+  randDistribution(0, 1),
+  randEngine(::std::random_device()())
+{
+}
+
+ParallelShortcutOptimizer::~ParallelShortcutOptimizer()
+{
+}
+
+bool
+ParallelShortcutOptimizer::isFree(rl::plan::SimpleModel* model, const ::rl::math::Vector& u, const ::rl::math::Vector& v) const
+{
+  if (NULL != this->continuous)
+  {
+    ::rl::math::Real contact = 0;
+    ::std::size_t queries = 0;
+    return this->continuous->advance(model, u, v, contact, queries);
+  }
+
+  ::std::size_t steps = static_cast< ::std::size_t >(::std::ceil(model->distance(u, v) / this->delta));
+  ::std::vector< ::rl::math::Real > alphas;
+
+  // Both endpoints lie on the current path, check the interior coarse to fine
+  ::std::deque< ::std::pair< ::std::size_t, ::std::size_t > > intervals;
+  intervals.push_back(::std::make_pair(0, steps));
+
+  while (!intervals.empty())
+  {
+    ::std::size_t lo = intervals.front().first;
+    ::std::size_t hi = intervals.front().second;
+    intervals.pop_front();
+
+    ::std::size_t mid = (lo + hi) / 2;
+
+    if (mid == lo)
+    {
+      continue;
+    }
+
+    alphas.push_back(static_cast< ::rl::math::Real >(mid) / steps);
+    intervals.push_back(::std::make_pair(lo, mid));
+    intervals.push_back(::std::make_pair(mid, hi));
+  }
+
+  // In bisection order, the frames of each block are computed at once
+  ::std::size_t queries = 0;
+  return this->batch.firstCollision(model, u, v, alphas, queries) == alphas.size();
+}
+
+void
+ParallelShortcutOptimizer::pointAt(const ::std::vector< ::rl::math::Vector >& path, const ::std::vector< ::rl::math::Real >& lengths, const ::rl::math::Real& s, ::rl::math::Vector& q, ::std::size_t& segment) const
+{
+  // lengths[i] is the arc length at path[i], segment i runs from path[i] to path[i + 1]
+  segment = ::std::upper_bound(lengths.begin(), lengths.end(), s) - lengths.begin() - 1;
+  segment = (::std::min)(segment, path.size() - 2);
+
+  ::rl::math::Real length = lengths[segment + 1] - lengths[segment];
+  ::rl::math::Real alpha = length > 0 ? (s - lengths[segment]) / length : 0;
+
+  this->model->interpolate(path[segment], path[segment + 1], (::std::min)(alpha, static_cast< ::rl::math::Real >(1)), q);
+}
+
+void
+ParallelShortcutOptimizer::process(rl::plan::VectorList& path)
+{
+  ::std::vector< ::rl::math::Vector > waypoints(path.begin(), path.end());
+
+  if (waypoints.size() < 3)
+  {
+    return;
+  }
+
+  ::std::vector< ::rl::math::Real > lengths;
+  ::std::size_t stalled = 0;
+
+  for (::std::size_t round = 0; round < this->rounds && stalled < this->patience; ++round)
+  {
+    EventTracer::Span span("optimizer", "shortcut round");
+
+    lengths.assign(1, 0);
+
+    for (::std::size_t i = 1; i < waypoints.size(); ++i)
+    {
+      lengths.push_back(lengths.back() + this->model->distance(waypoints[i - 1], waypoints[i]));
+    }
+
+    // Draw candidates between two random points along the path
+    ::std::vector< Shortcut > shortcuts;
+
+    for (::std::size_t k = 0; k < this->candidates; ++k)
+    {
+      Shortcut shortcut;
+      shortcut.begin = this->randDistribution(this->randEngine) * lengths.back();
+      shortcut.end = this->randDistribution(this->randEngine) * lengths.back();
+
+      if (shortcut.end < shortcut.begin)
+      {
+        ::std::swap(shortcut.begin, shortcut.end);
+      }
+
+      this->pointAt(waypoints, lengths, shortcut.begin, shortcut.u, shortcut.beginSegment);
+      this->pointAt(waypoints, lengths, shortcut.end, shortcut.v, shortcut.endSegment);
+
+      // A shortcut within one segment cannot shorten the path
+      if (shortcut.beginSegment == shortcut.endSegment)
+      {
+        continue;
+      }
+
+      shortcut.saving = (shortcut.end - shortcut.begin) - this->model->distance(shortcut.u, shortcut.v);
+      shortcut.free = false;
+
+      if (shortcut.saving > 1.0e-6)
+      {
+        shortcuts.push_back(shortcut);
+      }
+    }
+
+    this->verify(shortcuts);
+
+    // Greedily keep the largest valid savings whose path intervals do not overlap
+    ::std::sort(shortcuts.begin(), shortcuts.end(), [](const Shortcut& lhs, const Shortcut& rhs) { return lhs.saving > rhs.saving; });
+
+    ::std::vector< Shortcut > accepted;
+
+    for (::std::size_t k = 0; k < shortcuts.size(); ++k)
+    {
+      if (!shortcuts[k].free)
+      {
+        continue;
+      }
+
+      bool overlaps = false;
+
+      for (::std::size_t l = 0; l < accepted.size() && !overlaps; ++l)
+      {
+        overlaps = shortcuts[k].begin < accepted[l].end && accepted[l].begin < shortcuts[k].end;
+      }
+
+      if (!overlaps)
+      {
+        accepted.push_back(shortcuts[k]);
+      }
+    }
+
+    if (accepted.empty())
+    {
+      ++stalled;
+      continue;
+    }
+
+    stalled = 0;
+
+    ::std::sort(accepted.begin(), accepted.end(), [](const Shortcut& lhs, const Shortcut& rhs) { return lhs.begin < rhs.begin; });
+
+    // Splice the accepted shortcuts into the path
+    ::std::vector< ::rl::math::Vector > shortened;
+    ::std::size_t next = 0;
+
+    for (::std::size_t k = 0; k < accepted.size(); ++k)
+    {
+      for (; next <= accepted[k].beginSegment; ++next)
+      {
+        shortened.push_back(waypoints[next]);
+      }
+
+      shortened.push_back(accepted[k].u);
+      shortened.push_back(accepted[k].v);
+      next = accepted[k].endSegment + 1;
+    }
+
+    for (; next < waypoints.size(); ++next)
+    {
+      shortened.push_back(waypoints[next]);
+    }
+
+    waypoints.swap(shortened);
+  }
+
+  this->prune(waypoints);
+
+  path.assign(waypoints.begin(), waypoints.end());
+
+  if (NULL != this->viewer)
+  {
+    this->viewer->drawConfigurationPath(path);
+  }
+}
+
+void
+ParallelShortcutOptimizer::prune(::std::vector< ::rl::math::Vector >& path) const
+{
+  ::std::vector< ::rl::math::Vector > pruned(1, path.front());
+  ::std::size_t i = 0;
+
+  while (i + 1 < path.size())
+  {
+    ::std::size_t j = path.size() - 1;
+
+    while (j > i + 1 && !this->isFree(this->models.front(), path[i], path[j]))
+    {
+      --j;
+    }
+
+    pruned.push_back(path[j]);
+    i = j;
+  }
+
+  path.swap(pruned);
+}
+
+void
+ParallelShortcutOptimizer::seed(const ::std::mt19937::result_type& value)
+{
+  this->randEngine.seed(value);
+}
+
+void
+ParallelShortcutOptimizer::verify(::std::vector< Shortcut >& shortcuts) const
+{
+  ::std::atomic< ::std::size_t > next(0);
+
+  auto worker = [&](rl::plan::SimpleModel* model)
+  {
+    EventTracer::Span span("optimizer", "verify shortcuts");
+
+    for (::std::size_t k = next++; k < shortcuts.size(); k = next++)
+    {
+      shortcuts[k].free = this->isFree(model, shortcuts[k].u, shortcuts[k].v);
+    }
+  };
+
+  ::std::vector< ::std::thread > threads;
+
+  for (::std::size_t i = 1; i < this->models.size(); ++i)
+  {
+    threads.push_back(::std::thread(worker, this->models[i]));
+  }
+
+  worker(this->models.front());
+
+  for (::std::size_t i = 0; i < threads.size(); ++i)
+  {
+    threads[i].join();
+  }
+}
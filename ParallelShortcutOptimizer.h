@@ -0,0 +1,84 @@
+#ifndef _PARALLEL_SHORTCUT_OPTIMIZER_H_
+#define _PARALLEL_SHORTCUT_OPTIMIZER_H_
+
+#include <random>
+#include <vector>
+#include <rl/plan/Optimizer.h>
+#include <rl/plan/SimpleModel.h>
+
+#include "BatchKinematics.h"
+#include "ContinuousVerifier.h"
+
+/**
+*	Randomized path shortcutting, verified in parallel.
+*	Every round draws candidate shortcuts between two random points along the
+*	path, checks them concurrently (worker i only touches models[i]) and
+*	applies the non-overlapping valid ones with the largest savings.
+*	A final greedy pass removes the waypoints that can be skipped.
+*/
+class ParallelShortcutOptimizer : public rl::plan::Optimizer
+{
+public:
+  ParallelShortcutOptimizer();
+
+  virtual ~ParallelShortcutOptimizer();
+
+  void process(rl::plan::VectorList& path);
+
+  void seed(const ::std::mt19937::result_type& value);
+
+  /** One collision model per worker thread, the models must not be shared */
+  ::std::vector< rl::plan::SimpleModel* > models;
+
+  /** Candidate shortcuts drawn per round */
+  ::std::size_t candidates;
+
+  /** Maximum number of rounds */
+  ::std::size_t rounds;
+
+  /** Stop after this many rounds without improvement */
+  ::std::size_t patience;
+
+  /** Collision checking resolution along a shortcut */
+  ::rl::math::Real delta;
+
+  /** Frames of the shortcut steps a block at a time, falls back to the model's kinematics until calibrated */
+  BatchKinematics batch;
+
+  /** Checks shortcuts by conservative advancement instead of delta steps, NULL = off */
+  const ContinuousVerifier* continuous;
+
+protected:
+  struct Shortcut
+  {
+    ::rl::math::Real begin;  // arc length of the first point
+    ::rl::math::Real end;    // arc length of the second point
+    ::std::size_t beginSegment;
+    ::std::size_t endSegment;
+    ::rl::math::Vector u;
+    ::rl::math::Vector v;
+    ::rl::math::Real saving;
+    bool free;
+  };
+
+  /** Checks u-v at resolution delta in bisection order, so collisions are found early */
+  bool isFree(rl::plan::SimpleModel* model, const ::rl::math::Vector& u, const ::rl::math::Vector& v) const;
+
+  /** Verifies all shortcuts with one worker thread per model */
+  void verify(::std::vector< Shortcut >& shortcuts) const;
+
+  /** Point at arc length s and the index of its segment */
+  void pointAt(const ::std::vector< ::rl::math::Vector >& path, const ::std::vector< ::rl::math::Real >& lengths, const ::rl::math::Real& s, ::rl::math::Vector& q, ::std::size_t& segment) const;
+
+  /** Skips every waypoint that has a free shortcut from an earlier waypoint */
+  void prune(::std::vector< ::rl::math::Vector >& path) const;
+
+  ::std::uniform_real_distribution< ::rl::math::Real > randDistribution;
+
+  ::std::mt19937 randEngine;
+
+private:
+
+};
+
+#endif // _PARALLEL_SHORTCUT_OPTIMIZER_H_
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include "PhaseProfiler.h"
+
+::std::atomic< bool > PhaseProfiler::counting(false);
+
+::std::mutex PhaseProfiler::mutex;
+
+::std::vector< ::std::shared_ptr< PhaseProfiler::Thread > > PhaseProfiler::threads;
+
+PhaseProfiler::Slot PhaseProfiler::retired[PhaseProfiler::PHASES];
+
+PhaseProfiler::Thread::Thread() :
+  hardware(),
+  opened(false)
+{
+  for (::std::size_t i = 0; i < PHASES; ++i)
+  {
+    this->slots[i].calls = 0;
+    this->slots[i].nanoseconds = 0;
+
+    for (::std::size_t j = 0; j < HardwareCounters::COUNTERS; ++j)
+    {
+      this->slots[i].counters[j] = 0;
+    }
+
+    this->active[i] = false;
+  }
+}
+
+PhaseProfiler::Registration::~Registration()
+{
+  if (!this->thread)
+  {
+    return;
+  }
+
+  // Short-lived threads would otherwise keep a slot and a counter group each until the process ends
+  this->thread->hardware.close();
+
+  ::std::lock_guard< ::std::mutex > lock(mutex);
+
+  for (::std::size_t i = 0; i < PHASES; ++i)
+  {
+    add(retired[i].calls, this->thread->slots[i].calls.load(::std::memory_order_relaxed));
+    add(retired[i].nanoseconds, this->thread->slots[i].nanoseconds.load(::std::memory_order_relaxed));
+
+    for (::std::size_t j = 0; j < HardwareCounters::COUNTERS; ++j)
+    {
+      add(retired[i].counters[j], this->thread->slots[i].counters[j].load(::std::memory_order_relaxed));
+    }
+  }
+
+  threads.erase(::std::find(threads.begin(), threads.end(), this->thread));
+}
+
+PhaseProfiler::Scope::Scope(const Phase& phase) :
+  phase(phase),
+  outermost(!local().active[phase]),
+  reading(false),
+  start()
+{
+  if (this->outermost)
+  {
+    Thread& thread = local();
+    thread.active[phase] = true;
+
+    if (isCounted(phase) && counting.load(::std::memory_order_relaxed))
+    {
+      if (!thread.opened)
+      {
+        thread.opened = true;
+        thread.hardware.open();
+      }
+
+      this->reading = thread.hardware.read(this->counters);
+    }
+
+    this->start = ::std::chrono::steady_clock::now();
+  }
+}
+
+PhaseProfiler::Scope::~Scope()
+{
+  if (this->outermost)
+  {
+    ::std::chrono::steady_clock::duration elapsed = ::std::chrono::steady_clock::now() - this->start;
+    Thread& thread = local();
+    thread.active[this->phase] = false;
+    add(thread.slots[this->phase].calls, 1);
+    add(thread.slots[this->phase].nanoseconds, ::std::chrono::duration_cast< ::std::chrono::nanoseconds >(elapsed).count());
+
+    ::std::uint64_t counters[HardwareCounters::COUNTERS];
+
+    if (this->reading && thread.hardware.read(counters))
+    {
+      for (::std::size_t i = 0; i < HardwareCounters::COUNTERS; ++i)
+      {
+        add(thread.slots[this->phase].counters[i], counters[i] > this->counters[i] ? counters[i] - this->counters[i] : 0);
+      }
+    }
+  }
+}
+
+void
+PhaseProfiler::add(::std::atomic< ::std::uint64_t >& value, const ::std::uint64_t& amount)
+{
+  // Only the owning thread writes, a relaxed load and store is enough
+  value.store(value.load(::std::memory_order_relaxed) + amount, ::std::memory_order_relaxed);
+}
+
+void
+PhaseProfiler::count(const Phase& phase)
+{
+  add(local().slots[phase].calls, 1);
+}
+
+void
+PhaseProfiler::get(const Phase& phase, ::std::uint64_t& calls, double& milliseconds)
+{
+  ::std::lock_guard< ::std::mutex > lock(mutex);
+  calls = retired[phase].calls.load(::std::memory_order_relaxed);
+  ::std::uint64_t nanoseconds = retired[phase].nanoseconds.load(::std::memory_order_relaxed);
+
+  for (::std::size_t i = 0; i < threads.size(); ++i)
+  {
+    calls += threads[i]->slots[phase].calls.load(::std::memory_order_relaxed);
+    nanoseconds += threads[i]->slots[phase].nanoseconds.load(::std::memory_order_relaxed);
+  }
+
+  milliseconds = nanoseconds / 1.0e6;
+}
+
+void
+PhaseProfiler::get(const Phase& phase, ::std::uint64_t (&counters)[HardwareCounters::COUNTERS])
+{
+  ::std::lock_guard< ::std::mutex > lock(mutex);
+
+  for (::std::size_t j = 0; j < HardwareCounters::COUNTERS; ++j)
+  {
+    counters[j] = retired[phase].counters[j].load(::std::memory_order_relaxed);
+
+    for (::std::size_t i = 0; i < threads.size(); ++i)
+    {
+      counters[j] += threads[i]->slots[phase].counters[j].load(::std::memory_order_relaxed);
+    }
+  }
+}
+
+const char*
+PhaseProfiler::getName(const Phase& phase)
+{
+  const char* names[] = {"choose", "nearest", "connect", "extend", "rejection", "kinematics", "collision"};
+  return names[phase];
+}
+
+PhaseProfiler::Thread&
+PhaseProfiler::local()
+{
+  static thread_local Registration registration;
+
+  if (!registration.thread)
+  {
+    registration.thread = ::std::make_shared< Thread >();
+    ::std::lock_guard< ::std::mutex > lock(mutex);
+    threads.push_back(registration.thread);
+  }
+
+  return *registration.thread;
+}
+
+void
+PhaseProfiler::report(::std::ostream& stream)
+{
+  for (::std::size_t i = 0; i < PHASES; ++i)
+  {
+    ::std::uint64_t calls = 0;
+    double milliseconds = 0;
+    get(static_cast< Phase >(i), calls, milliseconds);
+
+    if (0 == calls)
+    {
+      continue;
+    }
+
+    stream << "phase " << ::std::left << ::std::setw(10) << getName(static_cast< Phase >(i)) << ::std::right << " " << calls;
+
+    if (REJECTION == i)
+    {
+      stream << " iterations" << ::std::endl;
+      continue;
+    }
+
+    stream << " calls " << milliseconds << " ms " << milliseconds * 1.0e6 / calls << " ns/call" << ::std::endl;
+
+    ::std::uint64_t counters[HardwareCounters::COUNTERS];
+    get(static_cast< Phase >(i), counters);
+
+    if (counters[HardwareCounters::CYCLES] > 0)
+    {
+      stream << "      " << ::std::setw(10) << "" << " IPC " << static_cast< double >(counters[HardwareCounters::INSTRUCTIONS]) / counters[HardwareCounters::CYCLES];
+
+      for (::std::size_t j = 0; j < HardwareCounters::COUNTERS; ++j)
+      {
+        stream << ", " << HardwareCounters::getName(static_cast< HardwareCounters::Counter >(j)) << " " << counters[j] / calls << "/call";
+      }
+
+      stream << ::std::endl;
+    }
+  }
+}
+
+void
+PhaseProfiler::reset()
+{
+  ::std::lock_guard< ::std::mutex > lock(mutex);
+
+  for (::std::size_t j = 0; j < PHASES; ++j)
+  {
+    retired[j].calls.store(0, ::std::memory_order_relaxed);
+    retired[j].nanoseconds.store(0, ::std::memory_order_relaxed);
+
+    for (::std::size_t k = 0; k < HardwareCounters::COUNTERS; ++k)
+    {
+      retired[j].counters[k].store(0, ::std::memory_order_relaxed);
+    }
+  }
+
+  for (::std::size_t i = 0; i < threads.size(); ++i)
+  {
+    for (::std::size_t j = 0; j < PHASES; ++j)
+    {
+      threads[i]->slots[j].calls.store(0, ::std::memory_order_relaxed);
+      threads[i]->slots[j].nanoseconds.store(0, ::std::memory_order_relaxed);
+
+      for (::std::size_t k = 0; k < HardwareCounters::COUNTERS; ++k)
+      {
+        threads[i]->slots[j].counters[k].store(0, ::std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+bool
+PhaseProfiler::setCounters(const bool& doOn)
+{
+  if (!doOn)
+  {
+    counting.store(false, ::std::memory_order_relaxed);
+    return true;
+  }
+
+  // Probe on the calling thread, the threads that count open their own group
+  HardwareCounters probe;
+
+  if (!probe.open())
+  {
+    std::cout << "PhaseProfiler: hardware counters unavailable (" << probe.getError() << "), timing only" << std::endl;
+    counting.store(false, ::std::memory_order_relaxed);
+    return false;
+  }
+
+  for (::std::size_t i = 0; i < HardwareCounters::COUNTERS; ++i)
+  {
+    if (!probe.isAvailable(static_cast< HardwareCounters::Counter >(i)))
+    {
+      std::cout << "PhaseProfiler: no " << HardwareCounters::getName(static_cast< HardwareCounters::Counter >(i)) << " counter, reported as 0" << std::endl;
+    }
+  }
+
+  counting.store(true, ::std::memory_order_relaxed);
+  return true;
+}
+
+void
+PhaseProfiler::writeCsv(::std::ostream& stream)
+{
+  for (::std::size_t i = 0; i < PHASES; ++i)
+  {
+    ::std::uint64_t calls = 0;
+    double milliseconds = 0;
+    get(static_cast< Phase >(i), calls, milliseconds);
+    stream << "," << calls << "," << milliseconds;
+  }
+
+  for (::std::size_t i = 0; i < PHASES; ++i)
+  {
+    if (!isCounted(static_cast< Phase >(i)))
+    {
+      continue;
+    }
+
+    ::std::uint64_t counters[HardwareCounters::COUNTERS];
+    get(static_cast< Phase >(i), counters);
+
+    for (::std::size_t j = 0; j < HardwareCounters::COUNTERS; ++j)
+    {
+      stream << "," << counters[j];
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#ifndef _PHASE_PROFILER_H_
+#define _PHASE_PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "HardwareCounters.h"
+
+/**
+*	Scoped timers and counters for the hot paths of the planners.
+*	Compiled in with PLANNER_PROFILE (cmake -DPLANNER_PROFILE=ON), otherwise
+*	PROFILE_SCOPE and PROFILE_COUNT expand to nothing and cost nothing.
+*
+*	Every thread adds to its own slots, only the owning thread writes them,
+*	so a scope costs two clock reads and no atomic read-modify-write. When a
+*	thread ends, its slots are added to the retired totals and released.
+*	Nested scopes of the same phase are counted once, by the outermost.
+*	Times are inclusive, connect contains the collision queries it makes.
+*
+*	With setCounters(true) nearest, connect and collision also read the
+*	hardware counters of their thread, where perf events are available.
+*/
+class PhaseProfiler
+{
+public:
+  enum Phase
+  {
+    CHOOSE,
+    NEAREST,
+    CONNECT,
+    EXTEND,
+    REJECTION,   // dynamic-domain rejection loop iterations, counted only
+    KINEMATICS,
+    COLLISION,
+    PHASES
+  };
+
+#ifdef PLANNER_PROFILE
+  static const bool enabled = true;
+#else
+  static const bool enabled = false;
+#endif
+
+  class Scope
+  {
+  public:
+    explicit Scope(const Phase& phase);
+
+    ~Scope();
+
+  private:
+    Phase phase;
+
+    bool outermost;
+
+    /** The counters were read when the scope began */
+    bool reading;
+
+    ::std::uint64_t counters[HardwareCounters::COUNTERS];
+
+    ::std::chrono::steady_clock::time_point start;
+  };
+
+  static void count(const Phase& phase);
+
+  /** Zeroes the slots of all threads, call between runs while no thread is profiling */
+  static void reset();
+
+  /** Calls and milliseconds of phase summed over all threads */
+  static void get(const Phase& phase, ::std::uint64_t& calls, double& milliseconds);
+
+  /** Hardware counters of phase summed over all threads */
+  static void get(const Phase& phase, ::std::uint64_t (&counters)[HardwareCounters::COUNTERS]);
+
+  static const char* getName(const Phase& phase);
+
+  /** True for the phases long enough to read the hardware counters around */
+  static bool isCounted(const Phase& phase) { return NEAREST == phase || CONNECT == phase || COLLISION == phase; }
+
+  /** Counts nearest, connect and collision in hardware, false if the counters cannot be opened */
+  static bool setCounters(const bool& doOn);
+
+  /** One line per phase with calls, total and mean time */
+  static void report(::std::ostream& stream);
+
+  /** ,calls,ms per phase, then the hardware counters of each counted phase, appended to a benchmark row */
+  static void writeCsv(::std::ostream& stream);
+
+private:
+  struct Slot
+  {
+    ::std::atomic< ::std::uint64_t > calls;
+    ::std::atomic< ::std::uint64_t > nanoseconds;
+    ::std::atomic< ::std::uint64_t > counters[HardwareCounters::COUNTERS];
+  };
+
+  struct Thread
+  {
+    Thread();
+
+    Slot slots[PHASES];
+
+    bool active[PHASES];
+
+    /** Opened on the first counted scope of the thread */
+    HardwareCounters hardware;
+
+    bool opened;
+  };
+
+  /** Holds the slots of a thread, folds them into the retired slots and closes its counters when the thread ends */
+  struct Registration
+  {
+    ~Registration();
+
+    ::std::shared_ptr< Thread > thread;
+  };
+
+  /** Slots of the calling thread, registered on first use */
+  static Thread& local();
+
+  static void add(::std::atomic< ::std::uint64_t >& value, const ::std::uint64_t& amount);
+
+  static ::std::atomic< bool > counting;
+
+  static ::std::mutex mutex;
+
+  static ::std::vector< ::std::shared_ptr< Thread > > threads;
+
+  /** Totals of the threads that have ended since the last reset() */
+  static Slot retired[PHASES];
+};
+
+#ifdef PLANNER_PROFILE
+#define PROFILE_SCOPE(phase) PhaseProfiler::Scope profileScope(PhaseProfiler::phase)
+#define PROFILE_COUNT(phase) PhaseProfiler::count(PhaseProfiler::phase)
+#else
+#define PROFILE_SCOPE(phase)
+#define PROFILE_COUNT(phase)
+#endif
+
+#endif // _PHASE_PROFILER_H_
@@ -0,0 +1,451 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <rl/plan/SimpleModel.h>
+#include <rl/plan/Viewer.h>
+
+#include "PrmPlanner.h"
+
+namespace
+{
+  const char magic[8] = {'R', 'L', 'P', 'R', 'M', '0', '0', '2'};
+}
+
+PrmPlanner::PrmPlanner() :
+  Planner(),
+  degree(15),
+  radius((::std::numeric_limits< ::rl::math::Real >::max)()),
+  steps(100),
+  lazy(false),
+  sampler(NULL),
+  verifier(NULL),
+  graph(),
+  queryVertices(),
+  path(),
+  queryTimes()
+{
+}
+
+PrmPlanner::~PrmPlanner()
+{
+}
+
+PrmPlanner::Vertex
+PrmPlanner::addVertex(const ::rl::plan::VectorPtr& q)
+{
+  // Collect the nearest neighbours before q is part of the graph
+  ::std::vector< ::std::pair< ::rl::math::Real, Vertex > > neighbors;
+
+  for (Vertex u = 0; u < ::boost::num_vertices(this->graph); ++u)
+  {
+    ::rl::math::Real d = this->model->distance(*q, *this->graph[u].q);
+
+    if (d <= this->radius)
+    {
+      neighbors.push_back(::std::make_pair(d, u));
+    }
+  }
+
+  ::std::size_t k = (::std::min)(this->degree, neighbors.size());
+  ::std::partial_sort(neighbors.begin(), neighbors.begin() + k, neighbors.end());
+
+  Vertex v = ::boost::add_vertex(this->graph);
+  this->graph[v].q = q;
+
+  if (NULL != this->viewer)
+  {
+    this->viewer->drawConfigurationVertex(*q);
+  }
+
+  for (::std::size_t i = 0; i < k; ++i)
+  {
+    const Vertex& u = neighbors[i].second;
+
+    if (!this->lazy && this->verifier->isColliding(*this->graph[u].q, *q, neighbors[i].first))
+    {
+      continue;
+    }
+
+    Edge e = ::boost::add_edge(u, v, this->graph).first;
+    this->graph[e].weight = neighbors[i].first;
+    this->graph[e].checked = !this->lazy;
+
+    if (NULL != this->viewer)
+    {
+      this->viewer->drawConfigurationEdge(*this->graph[u].q, *q);
+    }
+  }
+
+  return v;
+}
+
+void
+PrmPlanner::clear()
+{
+  this->graph.clear();
+  this->queryVertices.clear();
+  this->path.clear();
+  this->queryTimes.clear();
+}
+
+void
+PrmPlanner::construct(const ::std::size_t& count)
+{
+  for (::std::size_t i = 0; i < count; ++i)
+  {
+    this->addVertex(::std::make_shared< ::rl::math::Vector >(this->sampler->generateCollisionFree()));
+  }
+}
+
+::std::string
+PrmPlanner::getName() const
+{
+  return this->lazy ? "Lazy PRM" : "PRM";
+}
+
+::std::size_t
+PrmPlanner::getNumEdges() const
+{
+  return ::boost::num_edges(this->graph);
+}
+
+::std::size_t
+PrmPlanner::getNumVertices() const
+{
+  return ::boost::num_vertices(this->graph);
+}
+
+rl::plan::VectorList
+PrmPlanner::getPath()
+{
+  return this->path;
+}
+
+::rl::math::Real
+PrmPlanner::getQueryLatency(const ::rl::math::Real& p) const
+{
+  if (this->queryTimes.empty())
+  {
+    return 0;
+  }
+
+  ::std::vector< ::rl::math::Real > sorted(this->queryTimes);
+  ::std::sort(sorted.begin(), sorted.end());
+
+  return sorted[static_cast< ::std::size_t >(p * (sorted.size() - 1) + 0.5)];
+}
+
+bool
+PrmPlanner::load(const ::std::string& filename, ::std::uint64_t hash)
+{
+  ::std::ifstream file(filename.c_str(), ::std::ios::binary);
+
+  if (!file)
+  {
+    return false;
+  }
+
+  char header[sizeof(magic)];
+  ::std::uint64_t sceneHash = 0;
+  ::std::uint32_t dof = 0;
+  ::std::uint64_t numVertices = 0;
+  ::std::uint64_t numEdges = 0;
+
+  file.read(header, sizeof(header));
+  file.read(reinterpret_cast< char* >(&sceneHash), sizeof(sceneHash));
+  file.read(reinterpret_cast< char* >(&dof), sizeof(dof));
+  file.read(reinterpret_cast< char* >(&numVertices), sizeof(numVertices));
+  file.read(reinterpret_cast< char* >(&numEdges), sizeof(numEdges));
+
+  if (!file || 0 != ::std::memcmp(header, magic, sizeof(magic)) || dof != this->model->getDof())
+  {
+    std::cout << "PrmPlanner: " << filename << " is not a roadmap for this robot" << std::endl;
+    return false;
+  }
+
+  // The edges were verified in the scene the roadmap was built in
+  if (sceneHash != hash)
+  {
+    std::cout << "PrmPlanner: " << filename << " was built for another scene" << std::endl;
+    return false;
+  }
+
+  this->clear();
+
+  for (::std::uint64_t i = 0; i < numVertices; ++i)
+  {
+    ::rl::plan::VectorPtr q = ::std::make_shared< ::rl::math::Vector >(dof);
+
+    for (::std::size_t j = 0; j < dof; ++j)
+    {
+      double value;
+      file.read(reinterpret_cast< char* >(&value), sizeof(value));
+      (*q)(j) = value;
+    }
+
+    Vertex v = ::boost::add_vertex(this->graph);
+    this->graph[v].q = q;
+  }
+
+  for (::std::uint64_t i = 0; i < numEdges; ++i)
+  {
+    ::std::uint64_t u;
+    ::std::uint64_t v;
+    double weight;
+    ::std::uint8_t checked;
+
+    file.read(reinterpret_cast< char* >(&u), sizeof(u));
+    file.read(reinterpret_cast< char* >(&v), sizeof(v));
+    file.read(reinterpret_cast< char* >(&weight), sizeof(weight));
+    file.read(reinterpret_cast< char* >(&checked), sizeof(checked));
+
+    if (!file || u >= numVertices || v >= numVertices)
+    {
+      std::cout << "PrmPlanner: " << filename << " is truncated" << std::endl;
+      this->clear();
+      return false;
+    }
+
+    Edge e = ::boost::add_edge(u, v, this->graph).first;
+    this->graph[e].weight = weight;
+    this->graph[e].checked = 0 != checked;
+  }
+
+  return true;
+}
+
+void
+PrmPlanner::removeQuery()
+{
+  // Remove from the highest index down, so vecS renumbering keeps the others valid
+  ::std::sort(this->queryVertices.begin(), this->queryVertices.end(), ::std::greater< Vertex >());
+
+  for (::std::size_t i = 0; i < this->queryVertices.size(); ++i)
+  {
+    ::boost::clear_vertex(this->queryVertices[i], this->graph);
+    ::boost::remove_vertex(this->queryVertices[i], this->graph);
+  }
+
+  this->queryVertices.clear();
+}
+
+void
+PrmPlanner::reset()
+{
+  this->removeQuery();
+  this->path.clear();
+}
+
+bool
+PrmPlanner::save(const ::std::string& filename, ::std::uint64_t hash) const
+{
+  ::std::ofstream file(filename.c_str(), ::std::ios::binary | ::std::ios::trunc);
+
+  if (!file)
+  {
+    std::cout << "PrmPlanner: cannot write " << filename << std::endl;
+    return false;
+  }
+
+  // Query vertices are not part of the roadmap, renumber around them
+  ::std::vector< ::std::uint64_t > index(::boost::num_vertices(this->graph));
+  ::std::uint64_t numVertices = 0;
+
+  for (Vertex v = 0; v < ::boost::num_vertices(this->graph); ++v)
+  {
+    bool query = this->queryVertices.end() != ::std::find(this->queryVertices.begin(), this->queryVertices.end(), v);
+    index[v] = query ? (::std::numeric_limits< ::std::uint64_t >::max)() : numVertices++;
+  }
+
+  ::std::uint64_t numEdges = 0;
+
+  for (::boost::graph_traits< Graph >::edge_iterator e = ::boost::edges(this->graph).first; e != ::boost::edges(this->graph).second; ++e)
+  {
+    if (numVertices > index[::boost::source(*e, this->graph)] && numVertices > index[::boost::target(*e, this->graph)])
+    {
+      ++numEdges;
+    }
+  }
+
+  ::std::uint32_t dof = this->model->getDof();
+
+  file.write(magic, sizeof(magic));
+  file.write(reinterpret_cast< const char* >(&hash), sizeof(hash));
+  file.write(reinterpret_cast< const char* >(&dof), sizeof(dof));
+  file.write(reinterpret_cast< const char* >(&numVertices), sizeof(numVertices));
+  file.write(reinterpret_cast< const char* >(&numEdges), sizeof(numEdges));
+
+  for (Vertex v = 0; v < ::boost::num_vertices(this->graph); ++v)
+  {
+    if (index[v] >= numVertices)
+    {
+      continue;
+    }
+
+    for (::std::size_t j = 0; j < dof; ++j)
+    {
+      double value = (*this->graph[v].q)(j);
+      file.write(reinterpret_cast< const char* >(&value), sizeof(value));
+    }
+  }
+
+  for (::boost::graph_traits< Graph >::edge_iterator e = ::boost::edges(this->graph).first; e != ::boost::edges(this->graph).second; ++e)
+  {
+    ::std::uint64_t u = index[::boost::source(*e, this->graph)];
+    ::std::uint64_t v = index[::boost::target(*e, this->graph)];
+
+    if (u >= numVertices || v >= numVertices)
+    {
+      continue;
+    }
+
+    double weight = this->graph[*e].weight;
+    ::std::uint8_t checked = this->graph[*e].checked ? 1 : 0;
+
+    file.write(reinterpret_cast< const char* >(&u), sizeof(u));
+    file.write(reinterpret_cast< const char* >(&v), sizeof(v));
+    file.write(reinterpret_cast< const char* >(&weight), sizeof(weight));
+    file.write(reinterpret_cast< const char* >(&checked), sizeof(checked));
+  }
+
+  return static_cast< bool >(file);
+}
+
+bool
+PrmPlanner::search(const Vertex& begin, const Vertex& end, ::std::vector< Vertex >& route)
+{
+  typedef ::std::pair< ::rl::math::Real, Vertex > Entry;
+
+  ::std::size_t n = ::boost::num_vertices(this->graph);
+  ::std::vector< ::rl::math::Real > cost(n, (::std::numeric_limits< ::rl::math::Real >::max)());
+  ::std::vector< Vertex > parent(n, begin);
+  ::std::vector< bool > closed(n, false);
+  ::std::priority_queue< Entry, ::std::vector< Entry >, ::std::greater< Entry > > open;
+
+  cost[begin] = 0;
+  open.push(Entry(this->model->distance(*this->graph[begin].q, *this->graph[end].q), begin));
+
+  while (!open.empty())
+  {
+    Vertex v = open.top().second;
+    open.pop();
+
+    if (closed[v])
+    {
+      continue;
+    }
+
+    closed[v] = true;
+
+    if (v == end)
+    {
+      route.clear();
+
+      for (Vertex i = end; i != begin; i = parent[i])
+      {
+        route.push_back(i);
+      }
+
+      route.push_back(begin);
+      ::std::reverse(route.begin(), route.end());
+      return true;
+    }
+
+    for (::boost::graph_traits< Graph >::out_edge_iterator e = ::boost::out_edges(v, this->graph).first; e != ::boost::out_edges(v, this->graph).second; ++e)
+    {
+      Vertex w = ::boost::target(*e, this->graph);
+      ::rl::math::Real c = cost[v] + this->graph[*e].weight;
+
+      if (!closed[w] && c < cost[w])
+      {
+        cost[w] = c;
+        parent[w] = v;
+        open.push(Entry(c + this->model->distance(*this->graph[w].q, *this->graph[end].q), w));
+      }
+    }
+  }
+
+  return false;
+}
+
+bool
+PrmPlanner::solve()
+{
+  this->time = ::std::chrono::steady_clock::now();
+
+  this->removeQuery();
+  this->path.clear();
+
+  // A query is warm if it is answered without growing the roadmap
+  bool warm = ::boost::num_vertices(this->graph) > 0;
+
+  Vertex begin = this->addVertex(::std::make_shared< ::rl::math::Vector >(*this->start));
+  this->queryVertices.push_back(begin);
+  Vertex end = this->addVertex(::std::make_shared< ::rl::math::Vector >(*this->goal));
+  this->queryVertices.push_back(end);
+
+  ::std::vector< Vertex > route;
+
+  while ((::std::chrono::steady_clock::now() - this->time) < this->duration)
+  {
+    if (!this->search(begin, end, route))
+    {
+      this->construct(this->steps);
+      warm = false;
+      continue;
+    }
+
+    // Lazy edges are verified along the candidate path only, a colliding
+    // edge is removed and the search is repeated without it.
+    bool valid = true;
+
+    for (::std::size_t i = 0; i + 1 < route.size(); ++i)
+    {
+      Edge e = ::boost::edge(route[i], route[i + 1], this->graph).first;
+
+      if (!this->graph[e].checked && !this->validate(e))
+      {
+        valid = false;
+        break;
+      }
+    }
+
+    if (valid)
+    {
+      for (::std::size_t i = 0; i < route.size(); ++i)
+      {
+        this->path.push_back(*this->graph[route[i]].q);
+      }
+
+      if (warm)
+      {
+        this->queryTimes.push_back(::std::chrono::duration_cast< ::std::chrono::duration< ::rl::math::Real, ::std::milli > >(::std::chrono::steady_clock::now() - this->time).count());
+      }
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool
+PrmPlanner::validate(const Edge& e)
+{
+  Vertex u = ::boost::source(e, this->graph);
+  Vertex v = ::boost::target(e, this->graph);
+
+  if (this->verifier->isColliding(*this->graph[u].q, *this->graph[v].q, this->graph[e].weight))
+  {
+    ::boost::remove_edge(e, this->graph);
+    return false;
+  }
+
+  this->graph[e].checked = true;
+  return true;
+}
@@ -0,0 +1,135 @@
+#ifndef _PRM_PLANNER_H_
+#define _PRM_PLANNER_H_
+
+#include <cstdint>
+#include <boost/graph/adjacency_list.hpp>
+
+#include <rl/plan/Model.h>
+#include <rl/plan/Planner.h>
+#include <rl/plan/Sampler.h>
+#include <rl/plan/VectorPtr.h>
+#include <rl/plan/Verifier.h>
+
+/**
+ * Probabilistic Roadmaps for multi-query planning in a static scene.
+ *
+ * Lydia E. Kavraki, Petr Svestka, Jean-Claude Latombe, and Mark H. Overmars.
+ * Probabilistic roadmaps for path planning in high-dimensional configuration
+ * spaces. IEEE Transactions on Robotics and Automation, 12(4):566-580, 1996.
+ *
+ * With lazy set, edges are only verified once they lie on a shortest path
+ * (Bohlin and Kavraki, Path planning using lazy PRM, ICRA 2000).
+ *
+ * The roadmap survives reset() and can be saved and loaded, so later queries
+ * only connect start and goal and run an A* search.
+ */
+class PrmPlanner : public rl::plan::Planner
+{
+public:
+  PrmPlanner();
+
+  virtual ~PrmPlanner();
+
+  virtual ::std::string getName() const;
+
+  virtual ::std::size_t getNumEdges() const;
+
+  virtual ::std::size_t getNumVertices() const;
+
+  virtual rl::plan::VectorList getPath();
+
+  /** Removes the last query, the roadmap is kept */
+  virtual void reset();
+
+  virtual bool solve();
+
+  /** Removes the roadmap as well */
+  void clear();
+
+  /** Adds count collision-free vertices to the roadmap */
+  void construct(const ::std::size_t& count);
+
+  /** Loads the roadmap from filename, fails if it was built for another scene hash or dof */
+  bool load(const ::std::string& filename, ::std::uint64_t hash);
+
+  /** Saves the roadmap with the hash of the scene it is valid in, see SamplePool::hashFiles */
+  bool save(const ::std::string& filename, ::std::uint64_t hash) const;
+
+  /** Query latency percentile in ms over all warm queries, p in [0, 1] */
+  ::rl::math::Real getQueryLatency(const ::rl::math::Real& p) const;
+
+  ::std::size_t getNumQueries() const { return queryTimes.size(); }
+
+  /////////////////////////////////////////////////////////////////////////
+  // Planner parameters ///////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////
+
+  /** Maximum number of neighbours a new vertex is connected to. */
+  ::std::size_t degree;
+
+  /** Maximum distance of connected vertices. */
+  ::rl::math::Real radius;
+
+  /** Number of vertices added per construction round. */
+  ::std::size_t steps;
+
+  /** Verify edges only when they lie on a candidate path. */
+  bool lazy;
+
+  /** The sampler used for roadmap vertices */
+  ::rl::plan::Sampler* sampler;
+
+  /** The verifier used for roadmap edges */
+  ::rl::plan::Verifier* verifier;
+
+protected:
+  struct VertexBundle
+  {
+    ::rl::plan::VectorPtr q;
+  };
+
+  struct EdgeBundle
+  {
+    ::rl::math::Real weight;
+
+    bool checked;  // false until a lazy edge was verified
+  };
+
+  typedef ::boost::adjacency_list<
+  ::boost::listS,
+  ::boost::vecS,
+  ::boost::undirectedS,
+  VertexBundle,
+  EdgeBundle
+  > Graph;
+
+  typedef ::boost::graph_traits< Graph >::vertex_descriptor Vertex;
+
+  typedef ::boost::graph_traits< Graph >::edge_descriptor Edge;
+
+  /** Adds q and connects it to its nearest neighbours */
+  Vertex addVertex(const ::rl::plan::VectorPtr& q);
+
+  /** Verifies an edge that was not checked yet, removes it if colliding */
+  bool validate(const Edge& e);
+
+  /** A* from begin to end, returns false if they are not connected */
+  bool search(const Vertex& begin, const Vertex& end, ::std::vector< Vertex >& route);
+
+  /** Removes the start and goal vertices of the last query */
+  void removeQuery();
+
+  Graph graph;
+
+  /** Start and goal vertices of the last query */
+  ::std::vector< Vertex > queryVertices;
+
+  rl::plan::VectorList path;
+
+  ::std::vector< ::rl::math::Real > queryTimes;
+
+private:
+
+};
+
+#endif // _PRM_PLANNER_H_
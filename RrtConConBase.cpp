@@ -24,6 +24,7 @@
 // POSSIBILITY OF SUCH DAMAGE.
 //
 
+#include "PhaseProfiler.h"
 #include "RrtConConBase.h"
 #include <rl/plan/Sampler.h>
 #include <rl/plan/SimpleModel.h>
@@ -36,6 +37,7 @@ RrtConConBase::RrtConConBase() :
   delta(1.0f),
   epsilon(1.0e-3f),
   sampler(NULL),
+  sampleStream(NULL),
   begin(2),
   end(2),
   tree(2)
@@ -50,6 +52,7 @@ RrtConConBase::Edge
 RrtConConBase::addEdge(const Vertex& u, const Vertex& v, Tree& tree)
 {
   Edge e = ::boost::add_edge(u, v, tree).first;
+  tree[v].cost = tree[u].cost + this->model->distance(*tree[u].q, *tree[v].q);
 
   if (NULL != this->viewer)
   {
@@ -64,6 +67,7 @@ RrtConConBase::addVertex(Tree& tree, const ::rl::plan::VectorPtr& q)
   Vertex v = ::boost::add_vertex(tree);
   tree[v].index = ::boost::num_vertices(tree) - 1;
   tree[v].q = q;
+  tree[v].cost = 0;
 
   if (NULL != this->viewer)
   {
@@ -89,12 +93,26 @@ RrtConConBase::areEqual(const ::rl::math::Vector& lhs, const ::rl::math::Vector&
 void
 RrtConConBase::choose(::rl::math::Vector& chosen)
 {
+  PROFILE_SCOPE(CHOOSE);
+
+  if (NULL != this->sampleStream && this->sampleStream->read(chosen))
+  {
+    return;
+  }
+
   chosen = this->sampler->generate();
+
+  if (NULL != this->sampleStream)
+  {
+    this->sampleStream->write(chosen);
+  }
 }
 
 RrtConConBase::Vertex
 RrtConConBase::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen)
 {
+  PROFILE_SCOPE(CONNECT);
+
   //Do first extend step
 
   ::rl::math::Real distance = nearest.second;
@@ -117,7 +135,10 @@ RrtConConBase::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Ve
   this->model->interpolate(*tree[nearest.first].q, chosen, step / distance, *last);
 
   this->model->setPosition(*last);
-  this->model->updateFrames();
+  {
+    PROFILE_SCOPE(KINEMATICS);
+    this->model->updateFrames();
+  }
 
   if (this->model->isColliding())
   {
@@ -146,7 +167,10 @@ RrtConConBase::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Ve
     this->model->interpolate(*last, chosen, step / distance, next);
 
     this->model->setPosition(next);
-    this->model->updateFrames();
+    {
+      PROFILE_SCOPE(KINEMATICS);
+      this->model->updateFrames();
+    }
 
     if (this->model->isColliding())
     {
@@ -166,6 +190,8 @@ RrtConConBase::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Ve
 RrtConConBase::Vertex
 RrtConConBase::extend(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen)
 {
+  PROFILE_SCOPE(EXTEND);
+
   ::rl::math::Real distance = nearest.second;
   ::rl::math::Real step = (::std::min)(distance, this->delta);
 
@@ -174,7 +200,10 @@ RrtConConBase::extend(Tree& tree, const Neighbor& nearest, const ::rl::math::Vec
   this->model->interpolate(*tree[nearest.first].q, chosen, step / distance, *next);
 
   this->model->setPosition(*next);
-  this->model->updateFrames();
+  {
+    PROFILE_SCOPE(KINEMATICS);
+    this->model->updateFrames();
+  }
 
   if (!this->model->isColliding())
   {
@@ -249,6 +278,8 @@ RrtConConBase::getPath()
 RrtConConBase::Neighbor
 RrtConConBase::nearest(const Tree& tree, const ::rl::math::Vector& chosen)
 {
+  PROFILE_SCOPE(NEAREST);
+
   //create an empty pair <Vertex, distance> to return
   Neighbor p(Vertex(), (::std::numeric_limits< ::rl::math::Real >::max)());
 
@@ -271,6 +302,24 @@ RrtConConBase::nearest(const Tree& tree, const ::rl::math::Vector& chosen)
   return p;
 }
 
+void
+RrtConConBase::near(const Tree& tree, const ::rl::math::Vector& chosen, const ::rl::math::Real& radius, ::std::vector< Neighbor >& neighbors)
+{
+  neighbors.clear();
+
+  ::rl::math::Real transformedRadius = this->model->transformedDistance(radius);
+
+  for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
+  {
+    ::rl::math::Real d = this->model->transformedDistance(chosen, *tree[*i.first].q);
+
+    if (d <= transformedRadius)
+    {
+      neighbors.push_back(Neighbor(*i.first, this->model->inverseOfTransformedDistance(d)));
+    }
+  }
+}
+
 void
 RrtConConBase::reset()
 {
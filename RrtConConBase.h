@@ -39,6 +39,8 @@
 #include <rl/plan/VectorPtr.h>
 #include <rl/plan/Verifier.h>
 
+#include "SampleStream.h"
+
 /**
  * Rapidly-Exploring Random Trees.
  *
@@ -80,6 +82,9 @@ public:
   /** The sampler used for planning */
   ::rl::plan::Sampler* sampler;
 
+  /** Optional record/replay of the chosen samples (NULL = off) */
+  SampleStream* sampleStream;
+
 protected:
   /////////////////////////////////////////////////////////////////////////
   // boost graph definitions //////////////////////////////////////////////
@@ -97,6 +102,8 @@ protected:
     ::rl::math::Real tmp;
 
     ::rl::math::Real radius;  // ∞ for non-boundary, R for boundary
+
+    ::rl::math::Real cost;  // path length from the root of the tree
   };
 
   typedef ::boost::adjacency_list_traits<
@@ -132,7 +139,7 @@ protected:
   // helper functions ////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////
 
-  /** Add an edge to the RR-Tree */
+  /** Add an edge to the RR-Tree, v's cost becomes u's cost plus the edge length */
   virtual Edge addEdge(const Vertex& u, const Vertex& v, Tree& tree);
 
   /** Add a vertex to the RR-Tree */
@@ -156,6 +163,9 @@ protected:
   /** Returns the nearest neighbour of chosen in tree*/
   virtual Neighbor nearest(const Tree& tree, const ::rl::math::Vector& chosen);
 
+  /** Returns all vertices of tree within radius of chosen */
+  virtual void near(const Tree& tree, const ::rl::math::Vector& chosen, const ::rl::math::Real& radius, ::std::vector< Neighbor >& neighbors);
+
   ////////////////////////////////////////////////////////////////////////
   // members /////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////
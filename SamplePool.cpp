@@ -0,0 +1,279 @@
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "SamplePool.h"
+
+namespace
+{
+  const char magic[8] = {'R', 'L', 'P', 'O', 'O', 'L', '0', '1'};
+
+  struct Header
+  {
+    char magic[8];
+    ::std::uint64_t hash;
+    ::std::uint32_t dof;
+    ::std::uint32_t reserved;
+    ::std::uint64_t count;
+  };
+
+  bool
+  hashFile(const ::std::string& filename, ::std::uint64_t& hash)
+  {
+    ::std::ifstream file(filename.c_str(), ::std::ios::binary);
+
+    if (!file)
+    {
+      return false;
+    }
+
+    char buffer[4096];
+
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+    {
+      for (::std::streamsize i = 0; i < file.gcount(); ++i)
+      {
+        hash ^= static_cast< unsigned char >(buffer[i]);
+        hash *= 0x100000001b3ULL;
+      }
+    }
+
+    return true;
+  }
+
+  // Hashes filename and, depth first in document order, the files it references
+  // by href="..." (rlsg XML) or url "..." (VRML Inline), relative to its directory
+  bool
+  hashReferences(const ::std::string& filename, ::std::uint64_t& hash, ::std::set< ::std::string >& visited)
+  {
+    if (!visited.insert(filename).second)
+    {
+      return true;
+    }
+
+    if (!hashFile(filename, hash))
+    {
+      return false;
+    }
+
+    ::std::ifstream file(filename.c_str(), ::std::ios::binary);
+    ::std::string text((::std::istreambuf_iterator< char >(file)), ::std::istreambuf_iterator< char >());
+    ::std::string directory = filename.substr(0, filename.find_last_of("/\\") + 1);
+    const char* keys[] = {"href", "url"};
+
+    for (::std::size_t i = 0; i < text.size(); ++i)
+    {
+      for (::std::size_t k = 0; k < 2; ++k)
+      {
+        ::std::size_t length = ::std::strlen(keys[k]);
+
+        if (0 != text.compare(i, length, keys[k]) || (i > 0 && (::std::isalnum(static_cast< unsigned char >(text[i - 1])) || ':' == text[i - 1])))
+        {
+          continue;
+        }
+
+        ::std::size_t j = text.find_first_not_of(" \t\r\n=[", i + length);
+
+        if (::std::string::npos == j || '"' != text[j])
+        {
+          continue;
+        }
+
+        ::std::size_t end = text.find('"', j + 1);
+
+        if (::std::string::npos == end)
+        {
+          continue;
+        }
+
+        ::std::string reference = text.substr(j + 1, end - j - 1);
+
+        // Remote URLs are left out, absolute paths are taken as they are
+        if (reference.empty() || ::std::string::npos != reference.find("://"))
+        {
+          continue;
+        }
+
+        if (!hashReferences('/' == reference[0] ? reference : directory + reference, hash, visited))
+        {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+}
+
+SamplePool::SamplePool() :
+  data(NULL),
+  length(0),
+  samples(NULL),
+  dof(0),
+  count(0),
+  next(0)
+{
+}
+
+SamplePool::~SamplePool()
+{
+  this->close();
+}
+
+::std::uint64_t
+SamplePool::hashFile(const ::std::string& filename)
+{
+  ::std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+  if (!::hashFile(filename, hash))
+  {
+    return 0;
+  }
+
+  return hash;
+}
+
+::std::uint64_t
+SamplePool::hashFiles(const ::std::string& sceneFilename, const ::std::string& kinematicsFilename)
+{
+  ::std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+  ::std::set< ::std::string > visited;
+
+  if (!::hashReferences(sceneFilename, hash, visited) || !::hashReferences(kinematicsFilename, hash, visited))
+  {
+    return 0;
+  }
+
+  return hash;
+}
+
+bool
+SamplePool::write(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof, const ::rl::plan::VectorList& samples)
+{
+  ::std::ofstream file(filename.c_str(), ::std::ios::binary | ::std::ios::trunc);
+
+  if (!file)
+  {
+    std::cout << "SamplePool: cannot write " << filename << std::endl;
+    return false;
+  }
+
+  Header header;
+  ::std::memcpy(header.magic, magic, sizeof(magic));
+  header.hash = hash;
+  header.dof = static_cast< ::std::uint32_t >(dof);
+  header.reserved = 0;
+  header.count = samples.size();
+
+  file.write(reinterpret_cast< const char* >(&header), sizeof(header));
+
+  for (::rl::plan::VectorList::const_iterator i = samples.begin(); i != samples.end(); ++i)
+  {
+    for (::std::size_t j = 0; j < dof; ++j)
+    {
+      double value = (*i)(j);
+      file.write(reinterpret_cast< const char* >(&value), sizeof(value));
+    }
+  }
+
+  return static_cast< bool >(file);
+}
+
+bool
+SamplePool::open(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof)
+{
+  this->close();
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+
+  if (fd < 0)
+  {
+    std::cout << "SamplePool: cannot open " << filename << ", using live sampling" << std::endl;
+    return false;
+  }
+
+  struct stat status;
+
+  if (0 != ::fstat(fd, &status) || static_cast< ::std::size_t >(status.st_size) < sizeof(Header))
+  {
+    ::close(fd);
+    std::cout << "SamplePool: " << filename << " is truncated, using live sampling" << std::endl;
+    return false;
+  }
+
+  void* data = ::mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (MAP_FAILED == data)
+  {
+    std::cout << "SamplePool: cannot map " << filename << ", using live sampling" << std::endl;
+    return false;
+  }
+
+  this->data = data;
+  this->length = status.st_size;
+
+  const Header* header = static_cast< const Header* >(data);
+
+  if (0 != ::std::memcmp(header->magic, magic, sizeof(magic)) ||
+      header->dof != dof ||
+      sizeof(Header) + header->count * header->dof * sizeof(double) > this->length)
+  {
+    std::cout << "SamplePool: " << filename << " is not a pool for this robot, using live sampling" << std::endl;
+    this->close();
+    return false;
+  }
+
+  if (header->hash != hash)
+  {
+    std::cout << "SamplePool: " << filename << " is stale for this scene, using live sampling" << std::endl;
+    this->close();
+    return false;
+  }
+
+  ::madvise(data, this->length, MADV_SEQUENTIAL);
+
+  this->samples = reinterpret_cast< const double* >(static_cast< const char* >(data) + sizeof(Header));
+  this->dof = header->dof;
+  this->count = header->count;
+  this->next = 0;
+
+  return true;
+}
+
+void
+SamplePool::close()
+{
+  if (NULL != this->data)
+  {
+    ::munmap(this->data, this->length);
+  }
+
+  this->data = NULL;
+  this->length = 0;
+  this->samples = NULL;
+  this->dof = 0;
+  this->count = 0;
+  this->next = 0;
+}
+
+bool
+SamplePool::draw(::rl::math::Vector& q)
+{
+  if (NULL == this->samples || this->next >= this->count)
+  {
+    return false;
+  }
+
+  q = ::Eigen::Map< const ::Eigen::VectorXd >(this->samples + this->next * this->dof, this->dof).cast< ::rl::math::Real >();
+  ++this->next;
+
+  return true;
+}
@@ -0,0 +1,64 @@
+#ifndef _SAMPLE_POOL_H_
+#define _SAMPLE_POOL_H_
+
+#include <cstdint>
+#include <string>
+#include <rl/math/Vector.h>
+#include <rl/plan/VectorList.h>
+
+/**
+*	Precomputed collision-free configurations for one static scene.
+*	The pool file is memory-mapped read-only and drawn from front to back,
+*	draw() returns false once it is exhausted so callers fall back to live sampling.
+*
+*	File layout: 8 byte magic "RLPOOL01", uint64 scene hash, uint32 dof,
+*	uint32 reserved, uint64 count, then count * dof doubles.
+*/
+class SamplePool
+{
+public:
+  SamplePool();
+
+  virtual ~SamplePool();
+
+  /** FNV-1a hash over one file, 0 if it cannot be read */
+  static ::std::uint64_t hashFile(const ::std::string& filename);
+
+  /** FNV-1a hash over the scene and kinematics XML files and the geometry files they reference, 0 if one cannot be read */
+  static ::std::uint64_t hashFiles(const ::std::string& sceneFilename, const ::std::string& kinematicsFilename);
+
+  /** Writes a pool file for the given scene hash */
+  static bool write(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof, const ::rl::plan::VectorList& samples);
+
+  /** Maps filename, fails if it was built for another scene hash or dof */
+  bool open(const ::std::string& filename, ::std::uint64_t hash, ::std::size_t dof);
+
+  void close();
+
+  /** Copies the next pooled configuration into q, false if unmapped or exhausted */
+  bool draw(::rl::math::Vector& q);
+
+  /** Restarts drawing at the first configuration */
+  void rewind() { next = 0; }
+
+  bool isOpen() const { return NULL != samples; }
+
+  ::std::size_t getSize() const { return count; }
+
+  ::std::size_t getDrawn() const { return next; }
+
+private:
+  void* data;
+
+  ::std::size_t length;
+
+  const double* samples;
+
+  ::std::size_t dof;
+
+  ::std::size_t count;
+
+  ::std::size_t next;
+};
+
+#endif // _SAMPLE_POOL_H_
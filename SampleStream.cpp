@@ -0,0 +1,173 @@
+#include <cstring>
+#include <iostream>
+#include "SampleStream.h"
+
+namespace
+{
+  const char magic[8] = {'R', 'L', 'S', 'M', 'P', 'L', '0', '1'};
+}
+
+SampleStream::SampleStream() :
+  file(),
+  filename(),
+  mode(Mode::OFF),
+  dof(0),
+  count(0),
+  exhausted(false)
+{
+}
+
+SampleStream::~SampleStream()
+{
+  this->close();
+}
+
+bool
+SampleStream::open(const ::std::string& filename, Mode mode, ::std::size_t dof)
+{
+  this->close();
+
+  this->filename = filename;
+  this->mode = mode;
+  this->dof = static_cast< ::std::uint32_t >(dof);
+
+  if (Mode::OFF == mode)
+  {
+    return true;
+  }
+
+  this->rewind();
+
+  if (!this->file.is_open())
+  {
+    std::cout << "SampleStream: cannot open " << filename << std::endl;
+    this->mode = Mode::OFF;
+    return false;
+  }
+
+  return true;
+}
+
+void
+SampleStream::close()
+{
+  if (this->file.is_open())
+  {
+    this->file.flush();
+    this->file.close();
+  }
+
+  this->mode = Mode::OFF;
+  this->count = 0;
+  this->exhausted = false;
+}
+
+void
+SampleStream::rewind()
+{
+  this->count = 0;
+  this->exhausted = false;
+
+  if (this->file.is_open())
+  {
+    this->file.close();
+  }
+
+  this->file.clear();
+
+  if (Mode::RECORD == this->mode)
+  {
+    this->file.open(this->filename.c_str(), ::std::ios::out | ::std::ios::binary | ::std::ios::trunc);
+
+    if (!this->writeHeader())
+    {
+      this->file.close();
+    }
+  }
+  else if (Mode::REPLAY == this->mode)
+  {
+    this->file.open(this->filename.c_str(), ::std::ios::in | ::std::ios::binary);
+
+    if (!this->readHeader())
+    {
+      this->file.close();
+    }
+  }
+}
+
+bool
+SampleStream::read(::rl::math::Vector& q)
+{
+  if (Mode::REPLAY != this->mode || this->exhausted || !this->file.is_open())
+  {
+    return false;
+  }
+
+  q.resize(this->dof);
+
+  for (::std::size_t i = 0; i < this->dof; ++i)
+  {
+    double value;
+    this->file.read(reinterpret_cast< char* >(&value), sizeof(value));
+    q(i) = value;
+  }
+
+  if (!this->file)
+  {
+    std::cout << "SampleStream: replay exhausted after " << this->count << " samples, falling back to live sampling" << std::endl;
+    this->exhausted = true;
+    return false;
+  }
+
+  ++this->count;
+  return true;
+}
+
+void
+SampleStream::write(const ::rl::math::Vector& q)
+{
+  if (Mode::RECORD != this->mode || !this->file.is_open())
+  {
+    return;
+  }
+
+  for (::std::size_t i = 0; i < this->dof; ++i)
+  {
+    double value = q(i);
+    this->file.write(reinterpret_cast< const char* >(&value), sizeof(value));
+  }
+
+  ++this->count;
+}
+
+bool
+SampleStream::writeHeader()
+{
+  this->file.write(magic, sizeof(magic));
+  this->file.write(reinterpret_cast< const char* >(&this->dof), sizeof(this->dof));
+  return static_cast< bool >(this->file);
+}
+
+bool
+SampleStream::readHeader()
+{
+  char header[sizeof(magic)];
+  ::std::uint32_t fileDof = 0;
+
+  this->file.read(header, sizeof(header));
+  this->file.read(reinterpret_cast< char* >(&fileDof), sizeof(fileDof));
+
+  if (!this->file || 0 != ::std::memcmp(header, magic, sizeof(magic)))
+  {
+    std::cout << "SampleStream: " << this->filename << " is not a sample stream" << std::endl;
+    return false;
+  }
+
+  if (fileDof != this->dof)
+  {
+    std::cout << "SampleStream: " << this->filename << " has " << fileDof << " dof, expected " << this->dof << std::endl;
+    return false;
+  }
+
+  return true;
+}
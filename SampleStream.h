@@ -0,0 +1,71 @@
+#ifndef _SAMPLE_STREAM_H_
+#define _SAMPLE_STREAM_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <rl/math/Vector.h>
+
+/**
+*	Binary record/replay of the planner's sample stream.
+*	In RECORD mode every configuration returned by choose() is appended
+*	to the file, in REPLAY mode choose() reads them back in the same order,
+*	so two runs with the same stream grow identical trees.
+*
+*	File layout: 8 byte magic "RLSMPL01", uint32 dof, then dof doubles per sample.
+*/
+class SampleStream
+{
+public:
+  enum class Mode
+  {
+    OFF,
+    RECORD,
+    REPLAY
+  };
+
+  SampleStream();
+
+  virtual ~SampleStream();
+
+  /** Opens filename for recording or replaying samples of the given dof */
+  bool open(const ::std::string& filename, Mode mode, ::std::size_t dof);
+
+  void close();
+
+  /** Seeks back to the first sample (REPLAY) or truncates the file (RECORD) */
+  void rewind();
+
+  /** Reads the next recorded sample, returns false once the stream is exhausted */
+  bool read(::rl::math::Vector& q);
+
+  void write(const ::rl::math::Vector& q);
+
+  bool isRecording() const { return Mode::RECORD == mode; }
+
+  bool isReplaying() const { return Mode::REPLAY == mode; }
+
+  Mode getMode() const { return mode; }
+
+  /** Number of samples read or written since the last rewind */
+  ::std::size_t getCount() const { return count; }
+
+private:
+  bool writeHeader();
+
+  bool readHeader();
+
+  ::std::fstream file;
+
+  ::std::string filename;
+
+  Mode mode;
+
+  ::std::uint32_t dof;
+
+  ::std::size_t count;
+
+  bool exhausted;
+};
+
+#endif // _SAMPLE_STREAM_H_
@@ -1,34 +1,62 @@
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
 #include <fstream>
-#include <QDateTime>
+#include <iomanip>
+#include <limits>
+#include <sstream>
 #include "TutorialPlanSystem.h"
+#include "EventTracer.h"
+#include "JointWeights.h"
+#include "PhaseProfiler.h"
 #include "rl/math/Unit.h"
 #include "rl/math/Rotation.h"
 #include "rl/plan/UniformSampler.h"
 #include <iostream>
+#include <thread>
 
 
-TutorialPlanSystem::TutorialPlanSystem(rl::plan::DistributionType distType) :
+TutorialPlanSystem::TutorialPlanSystem(rl::plan::DistributionType distType, const std::string& sceneFilename, const std::string& kinematicsFilename) :
+  sceneFilename(sceneFilename),
+  kinematicsFilename(kinematicsFilename),
   sampler(distType),
-  planner(distType),
-  distributionType(distType)
+  useBatchKinematics(true),
+  useContinuousEdges(false),
+  useParallelOptimizer(false),
+  useKinematicWeights(false),
+  connectCandidates(1),
+  useCollisionIndex(false),
+  planner(YourPlanner::create("goalbias+weighted+dynamicdomain", distType)),
+  solver(planner.get()),
+  roadmapFilename(),
+  distributionType(distType),
+  deterministic(false),
+  seed(0)
 {
-  //  Loading the scene from an predefined xml file which contains the convex model of the robot as well as the sourroundings
-  //  Here's the collision scene where the puma 560 is loaded.
-  rl::sg::bullet::Scene* scene = new rl::sg::bullet::Scene();
-  scene->load("../xml/rlsg/unimation-puma560-rbo_wall.xml");
-  rl::sg::bullet::Model* sceneModel = static_cast< rl::sg::bullet::Model* > (scene->getModel(0));
+  //  Load the collision scene and the robot kinematics into our internal model
+  this->loadModel(this->model, this->kinematics);
 
-  //  Loading the kinematics of the puma 560 from a predefined xml file
-  this->kinematics = rl::kin::Kinematics::create("../xml/rlkin/unimation-puma560.xml");
-  this->kinematics->world() = ::rl::math::AngleAxis(90 * rl::math::constants::deg2rad, ::rl::math::Vector3::UnitZ());
-  this->kinematics->world().translation().x() = 0;
-  this->kinematics->world().translation().y() = 0;
-  this->kinematics->world().translation().z() = 0;
+  //  Batched forward kinematics is read from the model at q = 0 and only used
+  //  if it reproduces the model's frames, otherwise every step uses RL's kinematics.
+  this->batchKinematics.blockSize = 16;
+  if (!this->batchKinematics.calibrate(this->model))
+  {
+    std::cout << "batch kinematics: " << this->kinematicsFilename << " is no 6-DOF DH chain, using single kinematics" << std::endl;
+  }
 
-  //  Adding the robot kinematics and the scene to our internal model
-  this->model.kin = this->kinematics.get();
-  this->model.model = sceneModel;
-  this->model.scene = scene;
+  //  Collision queries check the full scene unless --pair-filter on, the pairs
+  //  are then reordered every 256 queries. The two-tier check against a proxy
+  //  scene is off as well until --proxy selects one.
+  this->model.reorderInterval = 256;
+
+  //  Every collision query of the planners and optimizers is recorded in the
+  //  occupancy grid, cells of cellSize radians per joint.
+  this->occupancy.cellSize = 0.2;
+  this->occupancy.minObservations = 3;
+  this->model.grid = &this->occupancy;
+
+  //  The weighted metric uses the linear weights, --weights kinematic estimates
+  //  weights from the kinematics and caches them in the working directory.
 
   //  Setting the start, goal and current position
   this->start.resize(kinematics->getDof());
@@ -52,36 +80,168 @@ TutorialPlanSystem::TutorialPlanSystem(rl::plan::DistributionType distType) :
   //  Set the model of the sampler to the system model
   this->sampler.model = &this->model;
 
+  //  The GAUSSIAN, BRIDGE and OBSTACLE modes mix in this share of uniform samples.
+  //  narrowSigma is the pair distance relative to each joint's range.
+  this->sampler.uniformRatio = 0.1;
+  this->sampler.narrowSigma = 0.05;
+
   //  --- Parametrize the planner ---
+  this->configurePlanner();
+
+  //  The PRM shares the problem, the sampler and the optimizer's verifier for its edges.
+  //  Roadmap vertices are connected to at most degree neighbours within radius.
+  this->prm.duration = this->planner->duration;
+  this->prm.goal = &this->goal;
+  this->prm.start = &this->start;
+  this->prm.sampler = &this->sampler;
+  this->prm.model = &this->model;
+  this->prm.verifier = &this->cachedVerifier;
+  this->prm.degree = 15;
+  this->prm.radius = 60 * rl::math::constants::deg2rad;
+
+  //  The baseline RRT-Connect solves the same problem with the same sampler and steps.
+  this->base.delta = this->planner->delta;
+  this->base.epsilon = this->planner->epsilon;
+  this->base.duration = this->planner->duration;
+  this->base.goal = &this->goal;
+  this->base.start = &this->start;
+  this->base.sampler = &this->sampler;
+  this->base.model = &this->model;
+  this->base.sampleStream = &this->sampleStream;
+
+  //  Set the parameters of the optimizer - you do not need to change these
+  this->optimizer.length = 15 * rl::math::constants::deg2rad;
+  this->optimizer.ratio = 0.05;
+  this->verifier.delta = 1 * rl::math::constants::deg2rad;
+  this->verifier.model = &this->model;
+  this->optimizer.verifier = &this->cachedVerifier;
+
+  //  The cache answers repeated and nested segment checks of the optimizer and
+  //  the PRM from memory, only segments of up to leafSteps steps reach verifier.
+  this->cachedVerifier.verifier = &this->verifier;
+  this->cachedVerifier.model = &this->model;
+  this->cachedVerifier.delta = this->verifier.delta;
+  this->cachedVerifier.leafSteps = 8;
+  this->optimizer.model = &this->model;
+
+  //  Continuous edge checking: radii bound how far any point of the robot moves
+  //  per radian of each joint [m], derived from the loaded kinematics and meshes.
+  //  Without them --edges continuous is refused. Distances below tolerance count as contact.
+  this->continuousVerifier.model = &this->model;
+  this->continuousVerifier.delta = this->verifier.delta;
+  if (!this->continuousVerifier.calibrate(this->model))
+  {
+    std::cout << "continuous verifier: " << this->kinematicsFilename << " is no revolute chain, continuous edges unavailable" << std::endl;
+  }
+  this->continuousVerifier.tolerance = 0.001;
+  this->continuousVerifier.maxSteps = 1000;
+
+  //  The parallel optimizer verifies shortcuts on one model per thread,
+  //  the clones are loaded on first use.
+  this->parallelOptimizer.model = &this->model;
+  this->parallelOptimizer.verifier = &this->verifier;
+  this->parallelOptimizer.delta = this->verifier.delta;
+  this->parallelOptimizer.candidates = 64;
+  this->parallelOptimizer.patience = 10;
+  this->parallelOptimizer.batch = this->batchKinematics;
+
+}
+
+void TutorialPlanSystem::configurePlanner()
+{
   //  Delta defines the configuration step width of a connect attempt.
   //  Here delta is set to 1° => 1° steps are checked during a connect.
   //  Attention, the robot might collide if delta is too large.
-  this->planner.delta = 1 * rl::math::constants::deg2rad;
+  this->planner->delta = 1 * rl::math::constants::deg2rad;
 
   //  Epsilon defines the distance between two configurations at which they are
   //  just identified as being identical.
-  this->planner.epsilon = 1.0e-8f;
+  this->planner->epsilon = 1.0e-8f;
 
   //  duration defines the time interval in which the planner tries to solve the problem.
   //  Here the planner stops after 1200 seconds of finding no solution.
-  this->planner.duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1200.0)); //[s]
+  this->planner->duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1200.0)); //[s]
 
   //  Setting the start and the goal position of the planner.
-  this->planner.goal = &this->goal;
-  this->planner.start = &this->start;
+  this->planner->goal = &this->goal;
+  this->planner->start = &this->start;
+
+  //  The weighted metric uses the kinematics-derived weights, an empty vector
+  //  makes the planner fall back to weights decreasing linearly from the base.
+  this->planner->weights = this->useKinematicWeights ? this->jointWeights : rl::math::Vector();
 
   //  Set the sampler and the model of the planner.
-  this->planner.sampler = &this->sampler;
-  this->planner.model = &this->model;
+  this->planner->sampler = &this->sampler;
+  this->planner->model = &this->model;
+  this->planner->sampleStream = &this->sampleStream;
 
-  //  Set the parameters of the optimizer - you do not need to change these
-  this->optimizer.length = 15 * rl::math::constants::deg2rad;
-  this->optimizer.ratio = 0.05;
-  this->verifier.delta = 1 * rl::math::constants::deg2rad;
-  this->verifier.model = &this->model;
-  this->optimizer.verifier = &this->verifier;
-  this->optimizer.model = &this->model;
+  //  Adaptive dynamic domain: a node becomes a boundary node with boundaryRadius
+  //  on its first failed extension, then its radius grows by boundaryGrowth on
+  //  every successful extension and shrinks by boundaryShrink on every failure.
+  this->planner->boundaryRadius = 15 * this->planner->delta;
+  this->planner->minBoundaryRadius = 1 * this->planner->delta;
+  this->planner->boundaryGrowth = 1.1;
+  this->planner->boundaryShrink = 0.9;
+
+  //  Share of samples drawn uniformly from the union of the boundary balls,
+  //  the rest comes from the sampler and keeps exploring the other regions.
+  this->planner->boundaryRatio = 0.5;
+
+  //  Anytime mode keeps rewiring both trees (RRT*-Connect) for anytimeDuration
+  //  after the first solution instead of returning it right away.
+  this->planner->useAnytime = false;
+  this->planner->anytimeDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(5.0)); //[s]
+  this->planner->rewireRadius = 10 * this->planner->delta;
+
+  //  Warm start keeps both trees between plan() calls and grafts a moved start
+  //  or goal onto them, reset() throws the trees away for a cold start.
+  //  Off by default, so every plan() starts cold; --warm-start on enables it.
+  this->planner->useWarmStart = false;
+  this->planner->graftCandidates = 10;
+
+  //  k-nearest connect: when the nearest vertex of the other tree gets stuck,
+  //  the next connectCandidates - 1 vertices are checked on the model clones.
+  this->planner->connectCandidates = this->connectCandidates;
+
+  //  Colliding configurations found while connecting are kept in a bounded index,
+  //  samples and first connect steps within radius of one are rejected without a query.
+  //  Off by default, it changes the planner's results and query counts; --collision-index on.
+  this->planner->useCollisionIndex = this->useCollisionIndex;
+  this->planner->collisionIndex.radius = 1 * this->planner->delta;
+  this->planner->collisionIndex.capacity = 4096;
+
+  //  Samples in occupancy cells known to collide are rejected without a query,
+  //  only with --occupancy FILE, see plan().
+  this->planner->occupancy = NULL;
+
+  //  Connect steps get their frames from the batched kinematics.
+  this->planner->batch = this->useBatchKinematics ? this->batchKinematics : BatchKinematics();
+
+  //  Connect segments are checked in delta steps unless continuous edges are on.
+  this->planner->continuous = this->useContinuousEdges ? &this->continuousVerifier : NULL;
+}
+
+rl::sg::bullet::Scene* TutorialPlanSystem::loadModel(rl::plan::DistanceModel& model, std::shared_ptr<rl::kin::Kinematics>& kinematics) const
+{
+  //  Loading the scene from an predefined xml file which contains the convex model of the robot as well as the sourroundings
+  //  Here's the collision scene where the puma 560 is loaded.
+  rl::sg::bullet::Scene* scene = new rl::sg::bullet::Scene();
+  scene->load(this->sceneFilename);
+  rl::sg::bullet::Model* sceneModel = static_cast< rl::sg::bullet::Model* > (scene->getModel(0));
+
+  //  Loading the kinematics of the puma 560 from a predefined xml file
+  kinematics = rl::kin::Kinematics::create(this->kinematicsFilename);
+  kinematics->world() = ::rl::math::AngleAxis(90 * rl::math::constants::deg2rad, ::rl::math::Vector3::UnitZ());
+  kinematics->world().translation().x() = 0;
+  kinematics->world().translation().y() = 0;
+  kinematics->world().translation().z() = 0;
+
+  //  Adding the robot kinematics and the scene to our internal model
+  model.kin = kinematics.get();
+  model.model = sceneModel;
+  model.scene = scene;
 
+  return scene;
 }
 
 TutorialPlanSystem::~TutorialPlanSystem()
@@ -106,6 +266,482 @@ void TutorialPlanSystem::getRandomFreeConfiguration(rl::math::Vector & config)
   config = sampler.generateCollisionFree();
 }
 
+void TutorialPlanSystem::setDistributionType(rl::plan::DistributionType distType)
+{
+  this->distributionType = distType;
+  this->sampler.setDistributionType(distType);
+  this->planner->distributionType = distType;
+}
+
+std::uint64_t TutorialPlanSystem::getSceneHash() const
+{
+  return SamplePool::hashFiles(this->sceneFilename, this->kinematicsFilename);
+}
+
+bool TutorialPlanSystem::loadSamplePool(const std::string& filename)
+{
+  if (!this->samplePool.open(filename, this->getSceneHash(), this->model.getDof()))
+  {
+    this->sampler.pool = NULL;
+    return false;
+  }
+
+  std::cout << "sample pool: " << this->samplePool.getSize() << " configurations from " << filename << std::endl;
+  this->sampler.pool = &this->samplePool;
+  return true;
+}
+
+rl::sg::bullet::Scene* TutorialPlanSystem::loadProxy(TwoTierModel& model, rl::plan::DistanceModel& proxy) const
+{
+  //  The proxy scene contains the same robot bodies with enclosing geometry
+  rl::sg::bullet::Scene* scene = new rl::sg::bullet::Scene();
+  scene->load(this->proxyFilename);
+  rl::sg::bullet::Model* sceneModel = static_cast< rl::sg::bullet::Model* > (scene->getModel(0));
+
+  if (sceneModel->getNumBodies() != model.model->getNumBodies())
+  {
+    std::cout << "proxy scene " << this->proxyFilename << " has " << sceneModel->getNumBodies()
+              << " bodies instead of " << model.model->getNumBodies() << std::endl;
+    model.proxy = NULL;
+    delete scene;
+    return NULL;
+  }
+
+  //  The proxy shares the kinematics, model hands it the body frames
+  proxy.kin = model.kin;
+  proxy.model = sceneModel;
+  proxy.scene = scene;
+  model.proxy = &proxy;
+
+  return scene;
+}
+
+bool TutorialPlanSystem::setProxyScene(const std::string& filename)
+{
+  this->proxyFilename = filename;
+
+  if (filename.empty())
+  {
+    this->model.proxy = NULL;
+    for (std::size_t i = 0; i < this->modelClones.size(); ++i)
+    {
+      this->modelClones[i]->model.proxy = NULL;
+    }
+    return true;
+  }
+
+  this->proxyScene.reset(this->loadProxy(this->model, this->proxyModel));
+  for (std::size_t i = 0; i < this->modelClones.size(); ++i)
+  {
+    this->modelClones[i]->proxyScene.reset(this->loadProxy(this->modelClones[i]->model, this->modelClones[i]->proxy));
+  }
+
+  if (NULL == this->model.proxy)
+  {
+    this->proxyFilename.clear();
+    return false;
+  }
+
+  //  A proxy that is free where the exact scene collides would let the planner through obstacles
+  if (!this->model.checkProxy(1000))
+  {
+    std::cout << "proxy scene " << filename << " does not enclose the exact scene, collision proxy disabled" << std::endl;
+    this->setProxyScene("");
+    return false;
+  }
+
+  std::cout << "collision proxy: " << filename << std::endl;
+  return true;
+}
+
+void TutorialPlanSystem::createModelClones(std::size_t count)
+{
+  //  Worker 0 uses the system model, every other worker gets its own scene
+  if (this->parallelOptimizer.models.empty())
+  {
+    this->parallelOptimizer.models.push_back(&this->model);
+  }
+
+  while (this->parallelOptimizer.models.size() < count)
+  {
+    std::shared_ptr<ModelClone> clone = std::make_shared<ModelClone>();
+    clone->scene.reset(this->loadModel(clone->model, clone->kinematics));
+    clone->model.grid = &this->occupancy;
+    clone->model.copyPairs(this->model);
+    if (!this->proxyFilename.empty())
+    {
+      clone->proxyScene.reset(this->loadProxy(clone->model, clone->proxy));
+    }
+    this->modelClones.push_back(clone);
+    this->parallelOptimizer.models.push_back(&clone->model);
+  }
+}
+
+void TutorialPlanSystem::loadJointWeights()
+{
+  std::string filename = this->kinematicsFilename.substr(this->kinematicsFilename.find_last_of("/\\") + 1);
+  filename = filename.substr(0, filename.find_last_of('.')) + ".weights";
+  std::uint64_t hash = SamplePool::hashFile(this->kinematicsFilename);
+
+  if (!JointWeights::load(filename, hash, this->model.getDof(), this->jointWeights))
+  {
+    this->jointWeights = JointWeights::estimate(this->model, 1000);
+    JointWeights::save(filename, hash, this->jointWeights);
+  }
+
+  std::cout << "joint weights:";
+  for (std::ptrdiff_t i = 0; i < this->jointWeights.size(); ++i)
+  {
+    std::cout << " " << this->jointWeights(i);
+  }
+  std::cout << std::endl;
+}
+
+bool TutorialPlanSystem::setJointWeights(const std::string& name)
+{
+  if ("kinematic" != name && "linear" != name)
+  {
+    std::cout << "unknown joint weights " << name << std::endl;
+    return false;
+  }
+
+  this->useKinematicWeights = ("kinematic" == name);
+
+  if (this->useKinematicWeights && 0 == this->jointWeights.size())
+  {
+    this->loadJointWeights();
+  }
+
+  this->planner->weights = this->useKinematicWeights ? this->jointWeights : rl::math::Vector();
+  return true;
+}
+
+bool TutorialPlanSystem::setForwardKinematics(const std::string& name)
+{
+  if ("batch" != name && "single" != name)
+  {
+    std::cout << "unknown forward kinematics " << name << std::endl;
+    return false;
+  }
+
+  //  A default BatchKinematics is not calibrated and falls back to the model
+  this->useBatchKinematics = ("batch" == name);
+  this->planner->batch = this->useBatchKinematics ? this->batchKinematics : BatchKinematics();
+  this->parallelOptimizer.batch = this->useBatchKinematics ? this->batchKinematics : BatchKinematics();
+  return true;
+}
+
+bool TutorialPlanSystem::setEdgeChecking(const std::string& name)
+{
+  if ("discrete" != name && "continuous" != name)
+  {
+    std::cout << "unknown edge checking " << name << std::endl;
+    return false;
+  }
+
+  if ("continuous" == name && 0 == this->continuousVerifier.radii.size())
+  {
+    std::cout << "continuous edges need the joint radii of a revolute chain, keeping discrete edges" << std::endl;
+    return false;
+  }
+
+  //  The cache hands whole segments to the continuous verifier, splitting them
+  //  into discrete midpoint checks would only add queries.
+  this->useContinuousEdges = ("continuous" == name);
+  this->planner->continuous = this->useContinuousEdges ? &this->continuousVerifier : NULL;
+  this->parallelOptimizer.continuous = this->useContinuousEdges ? &this->continuousVerifier : NULL;
+  this->cachedVerifier.verifier = this->useContinuousEdges ? static_cast< rl::plan::Verifier* >(&this->continuousVerifier) : &this->verifier;
+  this->cachedVerifier.leafSteps = this->useContinuousEdges ? std::numeric_limits<std::size_t>::max() : 8;
+  return true;
+}
+
+void TutorialPlanSystem::setConnectCandidates(std::size_t k)
+{
+  this->connectCandidates = std::max<std::size_t>(1, k);
+  this->planner->connectCandidates = this->connectCandidates;
+}
+
+void TutorialPlanSystem::setPairFilter(bool filter)
+{
+  //  Pairs that can never collide are dropped: fixed bodies apart from the scene
+  //  and scene bodies out of a link's reach. Pairs that never touched in 2000
+  //  random configurations are tested last, the rest most frequently colliding first.
+  if (filter)
+  {
+    this->model.filterPairs(2000);
+  }
+  else
+  {
+    this->model.clearPairs();
+  }
+
+  for (std::size_t i = 0; i < this->modelClones.size(); ++i)
+  {
+    this->modelClones[i]->model.copyPairs(this->model);
+  }
+}
+
+void TutorialPlanSystem::setCollisionIndex(bool collisionIndex)
+{
+  this->useCollisionIndex = collisionIndex;
+  this->planner->useCollisionIndex = collisionIndex;
+}
+
+bool TutorialPlanSystem::setOption(const std::string& name, const std::string& value)
+{
+  const char* samplerNames[] = {"uniform", "normal", "gaussian", "bridge", "obstacle", "clamped-normal"};
+
+  if ("sampler" == name)
+  {
+    for (std::size_t j = 0; j < sizeof(samplerNames) / sizeof(samplerNames[0]); ++j)
+    {
+      if (samplerNames[j] == value)
+      {
+        this->setDistributionType(static_cast< rl::plan::DistributionType >(j));
+        return true;
+      }
+    }
+
+    std::cout << "unknown sampler " << value << std::endl;
+    return false;
+  }
+  else if ("start" == name || "goal" == name)
+  {
+    //  Joint angles in degrees, separated by commas or spaces
+    std::string angles(value);
+    std::replace(angles.begin(), angles.end(), ',', ' ');
+    std::istringstream stream(angles);
+    rl::math::Vector config(this->start.size());
+    rl::math::Real degrees;
+    std::size_t count = 0;
+
+    while (stream >> degrees)
+    {
+      if (count < static_cast< std::size_t >(config.size()))
+      {
+        config(count) = degrees * rl::math::constants::deg2rad;
+      }
+
+      ++count;
+    }
+
+    if (count != static_cast< std::size_t >(config.size()))
+    {
+      std::cout << name << " needs " << config.size() << " joint angles, got " << count << std::endl;
+      return false;
+    }
+
+    if ("start" == name)
+    {
+      this->start = config;
+    }
+    else
+    {
+      this->goal = config;
+    }
+
+    return true;
+  }
+  else if ("seed" == name)
+  {
+    this->setSeed(std::strtoul(value.c_str(), NULL, 10));
+  }
+  else if ("record" == name)
+  {
+    return this->recordSamples(value);
+  }
+  else if ("replay" == name)
+  {
+    return this->replaySamples(value);
+  }
+  else if ("pool" == name)
+  {
+    return this->loadSamplePool(value);
+  }
+  else if ("planner" == name)
+  {
+    return this->setPlanner(value);
+  }
+  else if ("roadmap" == name)
+  {
+    this->setRoadmapFile(value);
+  }
+  else if ("anytime" == name)
+  {
+    this->setAnytime(std::strtod(value.c_str(), NULL));
+  }
+  else if ("fk" == name)
+  {
+    return this->setForwardKinematics(value);
+  }
+  else if ("edges" == name)
+  {
+    return this->setEdgeChecking(value);
+  }
+  else if ("proxy" == name)
+  {
+    return this->setProxyScene("off" == value ? "" : value);
+  }
+  else if ("occupancy" == name)
+  {
+    this->setOccupancyFile(value);
+  }
+  else if ("connect-k" == name)
+  {
+    this->setConnectCandidates(std::strtoul(value.c_str(), NULL, 10));
+  }
+  else if ("pair-filter" == name)
+  {
+    this->setPairFilter("on" == value);
+  }
+  else if ("collision-index" == name)
+  {
+    this->setCollisionIndex("on" == value);
+  }
+  else if ("weights" == name)
+  {
+    return this->setJointWeights(value);
+  }
+  else if ("warm-start" == name)
+  {
+    this->setWarmStart("on" == value);
+  }
+  else if ("optimizer" == name)
+  {
+    this->setParallelOptimizer("parallel" == value);
+  }
+  else if ("counters" == name)
+  {
+    return this->setHardwareCounters("on" == value);
+  }
+  else
+  {
+    std::cout << "unknown option --" << name << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool TutorialPlanSystem::setHardwareCounters(bool counters)
+{
+  if (!PhaseProfiler::enabled)
+  {
+    std::cout << "hardware counters need a build with PLANNER_PROFILE" << std::endl;
+    return false;
+  }
+
+  return PhaseProfiler::setCounters(counters);
+}
+
+void TutorialPlanSystem::setWarmStart(bool warmStart)
+{
+  this->planner->useWarmStart = warmStart;
+}
+
+void TutorialPlanSystem::setAnytime(double seconds)
+{
+  this->planner->useAnytime = seconds > 0;
+  this->planner->anytimeDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+bool TutorialPlanSystem::setPlanner(const std::string& name)
+{
+  if ("rrt" == name)
+  {
+    this->solver = this->planner.get();
+  }
+  else if (0 == name.compare(0, 4, "rrt:"))
+  {
+    std::shared_ptr<YourPlanner> planner = YourPlanner::create(name.substr(4), this->distributionType);
+
+    if (!planner)
+    {
+      return false;
+    }
+
+    //  The new planner keeps the options already set on the previous one
+    std::shared_ptr<YourPlanner> previous = this->planner;
+    this->planner = planner;
+    this->configurePlanner();
+    this->planner->useAnytime = previous->useAnytime;
+    this->planner->anytimeDuration = previous->anytimeDuration;
+    this->planner->useWarmStart = previous->useWarmStart;
+    this->planner->viewer = previous->viewer;
+
+    if (this->deterministic)
+    {
+      this->applySeed();
+    }
+
+    this->solver = this->planner.get();
+  }
+  else if ("base" == name)
+  {
+    this->solver = &this->base;
+  }
+  else if ("prm" == name || "lazyprm" == name)
+  {
+    this->prm.lazy = ("lazyprm" == name);
+    this->solver = &this->prm;
+  }
+  else
+  {
+    std::cout << "unknown planner " << name << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+void TutorialPlanSystem::setOccupancyFile(const std::string& filename)
+{
+  this->occupancyFilename = filename;
+
+  if (this->occupancy.load(filename, this->getSceneHash(), this->model.getDof()))
+  {
+    std::cout << "occupancy: " << this->occupancy.getSize() << " cells from " << filename << std::endl;
+  }
+}
+
+void TutorialPlanSystem::setRoadmapFile(const std::string& filename)
+{
+  this->roadmapFilename = filename;
+
+  if (this->prm.load(filename, this->getSceneHash()))
+  {
+    std::cout << "roadmap: " << this->prm.getNumVertices() << " vertices, " << this->prm.getNumEdges() << " edges from " << filename << std::endl;
+  }
+}
+
+void TutorialPlanSystem::setSeed(std::mt19937::result_type seed)
+{
+  this->deterministic = true;
+  this->seed = seed;
+  this->applySeed();
+}
+
+void TutorialPlanSystem::applySeed()
+{
+  //Derive independent sampler and planner seeds from the single seed
+  std::seed_seq sequence{this->seed};
+  std::uint32_t seeds[3];
+  sequence.generate(seeds, seeds + 3);
+  this->sampler.seed(seeds[0]);
+  this->planner->seed(seeds[1]);
+  this->parallelOptimizer.seed(seeds[2]);
+}
+
+bool TutorialPlanSystem::recordSamples(const std::string& filename)
+{
+  return this->sampleStream.open(filename, SampleStream::Mode::RECORD, this->model.getDof());
+}
+
+bool TutorialPlanSystem::replaySamples(const std::string& filename)
+{
+  return this->sampleStream.open(filename, SampleStream::Mode::REPLAY, this->model.getDof());
+}
+
 void TutorialPlanSystem::writeToFile(rl::plan::VectorList & path)
 {
   std::ofstream traj;
@@ -141,43 +777,182 @@ void TutorialPlanSystem::writeToFile(rl::plan::VectorList & path)
 
 bool TutorialPlanSystem::plan(rl::plan::VectorList & path)
 {
+  EventTracer::Span span("plan", "plan");
 
   //Verifies that the model, the start, and the goal position are all correct
-  if (!this->planner.verify())
+  if (!this->solver->verify())
   {
     std::cout << "start or goal invalid" << std::endl;
     return false;
   }
 
+  //In deterministic mode reseed, so every run explores the same tree.
+  if (this->deterministic)
+  {
+    this->applySeed();
+  }
+
+  this->sampleStream.rewind();
+  this->samplePool.rewind();
+  this->sampler.resetStatistics();
+  this->cachedVerifier.resetStatistics();
+  this->continuousVerifier.resetStatistics();
+  this->model.resetStatistics();
+  for (std::size_t i = 0; i < this->modelClones.size(); ++i)
+  {
+    this->modelClones[i]->model.resetStatistics();
+  }
+  PhaseProfiler::reset();
+
+  //The occupancy grid changes with every run, rejecting samples by it would make
+  //seeded and replayed runs grow different trees, so it is opt-in and off for those.
+  bool reproducible = this->deterministic || SampleStream::Mode::REPLAY == this->sampleStream.getMode();
+  this->planner->occupancy = !this->occupancyFilename.empty() && !reproducible ? &this->occupancy : NULL;
+
+  //Further connect candidates are checked in parallel, one model clone per thread
+  if (this->solver == this->planner.get() && this->connectCandidates > 1)
+  {
+    this->createModelClones(std::max(1u, std::min(8u, std::thread::hardware_concurrency())));
+    this->planner->connectModels = this->parallelOptimizer.models;
+  }
+
   //Call the planner to solve the current problem.
   std::cout << "solve() ... " << std::endl;;
   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
-  bool solved = this->planner.solve();
+  bool solved = false;
+  {
+    EventTracer::Span span("plan", "solve");
+    solved = this->solver->solve();
+  }
   std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
 
   double plannerDuration = std::chrono::duration_cast< std::chrono::duration<double>>(stop - start).count() * 1000;
-  //this->showMessage("Planner " + std::string(solved ? "succeeded" : "failed") + " in " + QString::number(plannerDuration).toStdString() + " ms.");
+  //this->showMessage("Planner " + std::string(solved ? "succeeded" : "failed") + " in " + std::to_string(plannerDuration) + " ms.");
+
+  std::cout << "solve() " << (solved ? "true" : "false") << " " << plannerDuration << " ms" << std::endl;
+
+  //Hot-path phases of solve() only, taken before the optimizer adds its queries
+  std::ostringstream phases;
+  if (PhaseProfiler::enabled)
+  {
+    PhaseProfiler::report(std::cout);
+    PhaseProfiler::writeCsv(phases);
+  }
 
-  std::cout << "solve() " << (solved ? "true" : "false") << " " << QString::number(plannerDuration).toStdString() << " ms" << std::endl;
+  //Dynamic domain: rejection loop acceptance and radius adaptation
+  if (this->solver == this->planner.get() && this->planner->useDynamicDomain)
+  {
+    const YourPlanner::DomainStatistics& domain = this->planner->getDomainStatistics();
+    std::cout << "dynamic domain: " << domain.samples << " samples, " << domain.rejected << " rejected, "
+              << domain.grown << " radius increases, " << domain.shrunk << " decreases, "
+              << domain.ballAccepted << " of " << domain.ballSamples << " ball samples accepted, "
+              << this->planner->getNumVertices() << " vertices" << std::endl;
+  }
+
+  //k-nearest connect: connection rate versus the extra collision queries
+  if (this->solver == this->planner.get() && this->connectCandidates > 1)
+  {
+    const YourPlanner::ConnectStatistics& connects = this->planner->getConnectStatistics();
+    std::cout << "k-nearest connect: " << connects.attempts << " attempts, " << connects.nearest << " reached from the nearest vertex, "
+              << connects.others << " from further candidates, " << connects.extraQueries << " extra collision queries" << std::endl;
+  }
+
+  //Continuous edges: distance evaluations per segment instead of a query every delta
+  if (this->solver == this->planner.get() && NULL != this->planner->continuous)
+  {
+    const YourPlanner::EdgeStatistics& edges = this->planner->getEdgeStatistics();
+    std::cout << "continuous edges: " << edges.edges << " connects, " << edges.queries << " distance queries, "
+              << edges.contacts << " stopped at a contact" << std::endl;
+  }
+
+  //Known-colliding index: Bullet queries saved by rejecting near known collisions
+  if (this->solver == this->planner.get() && this->planner->useCollisionIndex)
+  {
+    const YourPlanner::IndexStatistics& index = this->planner->getIndexStatistics();
+    std::cout << "collision index: " << this->planner->collisionIndex.getSize() << " configurations, "
+              << index.rejectedSamples << " samples rejected, " << index.avoidedQueries << " connect queries avoided" << std::endl;
+    std::cout << "occupancy: " << index.occupiedSamples << " samples rejected in known colliding cells" << std::endl;
+  }
+
+  //Warm start: report how much of the previous trees was reused
+  if (this->solver == this->planner.get() && this->planner->getReusedVertices() > 0)
+  {
+    std::cout << "warm start: reused " << this->planner->getReusedVertices() << " vertices" << std::endl;
+  }
+
+  //Anytime refinement: report how the best path cost developed
+  if (this->solver == this->planner.get() && this->planner->useAnytime && !this->planner->costHistory.empty())
+  {
+    std::cout << "anytime: first cost " << this->planner->costHistory.front().second
+              << " at " << this->planner->costHistory.front().first << " ms, best cost " << this->planner->costHistory.back().second
+              << " at " << this->planner->costHistory.back().first << " ms after "
+              << this->planner->costHistory.size() << " improvements" << std::endl;
+  }
+
+  //Roadmap planners: keep the roadmap for the next run and report warm query latency
+  if (this->solver == &this->prm)
+  {
+    if (!this->roadmapFilename.empty())
+    {
+      this->prm.save(this->roadmapFilename, this->getSceneHash());
+    }
+
+    if (this->prm.getNumQueries() > 0)
+    {
+      std::cout << "query latency over " << this->prm.getNumQueries() << " warm queries: p50 "
+                << this->prm.getQueryLatency(0.5) << " ms, p90 "
+                << this->prm.getQueryLatency(0.9) << " ms, p99 "
+                << this->prm.getQueryLatency(0.99) << " ms" << std::endl;
+    }
+  }
+
+  //Per-mode sampler statistics: collision checks spent versus vertices gained
+  const char* modeNames[] = {"uniform", "normal", "gaussian", "bridge", "obstacle", "clamped-normal"};
+  for (std::size_t i = 0; i < 6; ++i)
+  {
+    const rl::plan::YourSampler::Statistics& statistics = this->sampler.getStatistics(static_cast< rl::plan::DistributionType >(i));
+    if (statistics.samples > 0)
+    {
+      std::cout << "sampler " << modeNames[i] << ": " << statistics.samples << " samples, "
+                << statistics.collisionChecks << " collision checks, "
+                << statistics.vertices << " vertices" << std::endl;
+    }
+  }
+
+  //Pooled samples replace the mode's samples until the pool is exhausted
+  if (this->sampler.getPoolStatistics().samples > 0)
+  {
+    std::cout << "sampler pool: " << this->sampler.getPoolStatistics().samples << " samples, "
+              << this->sampler.getPoolStatistics().vertices << " vertices" << std::endl;
+  }
 
 
   //write statistics to file benchmark.csv
   //format: date, time, solved, Planner name, # vertices, # Collision queries, # non-colliding queries, running time
+  //built with PLANNER_PROFILE: followed by calls, ms for choose, nearest, connect, extend, rejection (ms 0), kinematics, collision
+  //then cycles, instructions, L1d misses, LLC misses, branch misses for nearest, connect, collision (0 without --counters)
   std::ofstream benchmark;
   benchmark.open("benchmark.csv", std::ios::app);
-  benchmark << QDateTime::currentDateTime().toString("yyyy-MM-dd,HH:mm:ss.zzz").toStdString();
+  std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+  std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+  std::tm local;
+  localtime_r(&seconds, &local);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%d,%H:%M:%S", &local);
+  benchmark << date << "." << std::setfill('0') << std::setw(3) << std::chrono::duration_cast< std::chrono::milliseconds >(now.time_since_epoch()).count() % 1000 << std::setfill(' ');
   benchmark << ",";
   benchmark << (solved ? "true" : "false");
   benchmark << ",";
-  benchmark << this->planner.getName();
+  benchmark << this->solver->getName();
   benchmark << ",";
-  benchmark << this->planner.getNumVertices();
+  benchmark << this->solver->getNumVertices();
   benchmark << ",";
   benchmark << this->model.getTotalQueries();
   benchmark << ",";
   benchmark << this->model.getFreeQueries();
   benchmark << ",";
   benchmark << plannerDuration;
+  benchmark << phases.str();
   benchmark << std::endl;
 
 
@@ -185,25 +960,123 @@ bool TutorialPlanSystem::plan(rl::plan::VectorList & path)
   if(solved)
   {
     //Found a solution so return the found path
-    path = this->planner.getPath();
+    //In anytime mode the best path is the one whose cost was reported
+    if (this->solver == this->planner.get() && this->planner->useAnytime)
+    {
+      path = this->planner->getBestPath();
+    }
+    else
+    {
+      path = this->solver->getPath();
+    }
 
     std::cout << "optimize() ... " << std::endl;;
 
     //optimize the trajectory.
     //Comment this line if you only want to test your planning algorithm
-    this->optimizer.process(path);
+    std::chrono::steady_clock::time_point optimizeStart = std::chrono::steady_clock::now();
+
+    {
+      EventTracer::Span span("plan", "optimize");
+      if (this->useParallelOptimizer)
+      {
+        this->createModelClones(std::max(1u, std::min(8u, std::thread::hardware_concurrency())));
+        rl::plan::VectorList input = path;
+        this->parallelOptimizer.process(path);
+
+        //The parallel shortcuts are not guaranteed to beat the input, never return a longer path
+        rl::math::Real inputLength = 0;
+        rl::math::Real outputLength = 0;
+        for (rl::plan::VectorList::iterator i = input.begin(), j = ++input.begin(); j != input.end(); ++i, ++j)
+        {
+          inputLength += this->model.distance(*i, *j);
+        }
+        for (rl::plan::VectorList::iterator i = path.begin(), j = ++path.begin(); j != path.end(); ++i, ++j)
+        {
+          outputLength += this->model.distance(*i, *j);
+        }
+        if (outputLength > inputLength)
+        {
+          std::cout << "parallel optimizer: result longer than its input, keeping the input" << std::endl;
+          path.swap(input);
+        }
+      }
+      else
+      {
+        this->optimizer.process(path);
+      }
+    }
+
+    double optimizerDuration = std::chrono::duration_cast< std::chrono::duration<double>>(std::chrono::steady_clock::now() - optimizeStart).count() * 1000;
+    std::cout << "optimize() " << path.size() << " waypoints " << optimizerDuration << " ms" << std::endl;
+
+    //Segment cache: how many collision queries repeated checks did not have to repeat
+    const CachedVerifier::Statistics& cacheStatistics = this->cachedVerifier.getStatistics();
+    if (cacheStatistics.calls > 0)
+    {
+      std::cout << "verifier cache: " << cacheStatistics.hits << " of " << cacheStatistics.calls << " segments from memory, "
+                << cacheStatistics.queries << " collision queries, " << cacheStatistics.saved << " saved" << std::endl;
+    }
+
+    const ContinuousVerifier::Statistics& continuousStatistics = this->continuousVerifier.getStatistics();
+    if (continuousStatistics.segments > 0)
+    {
+      std::cout << "continuous verifier: " << continuousStatistics.segments << " segments, "
+                << continuousStatistics.queries << " distance queries, " << continuousStatistics.contacts << " colliding" << std::endl;
+    }
 
     //Write trajectory to text file
     writeToFile(path);
   }
 
+  //Collision pairs: the pairs that stop colliding configurations first
+  if (this->model.getCandidatePairs() > 0)
+  {
+    const std::vector<CollisionPairModel::Pair>& pairs = this->model.getPairs();
+    std::cout << "collision pairs: " << pairs.size() << " of " << this->model.getCandidatePairs() << " active";
+    for (std::size_t i = 0; i < std::min<std::size_t>(3, pairs.size()) && pairs[i].collisions > 0; ++i)
+    {
+      std::cout << (0 == i ? ", first " : ", ") << this->model.getBodyName(pairs[i].firstModel, pairs[i].firstBody)
+                << "-" << this->model.getBodyName(pairs[i].secondModel, pairs[i].secondBody)
+                << " " << pairs[i].collisions << "/" << pairs[i].checks;
+    }
+    std::cout << std::endl;
+  }
+
+  //Two-tier collision checking: queries the proxy answered without the exact scene
+  if (NULL != this->model.proxy)
+  {
+    TwoTierModel::Statistics tiers = this->model.getStatistics();
+    for (std::size_t i = 0; i < this->modelClones.size(); ++i)
+    {
+      tiers.proxyQueries += this->modelClones[i]->model.getStatistics().proxyQueries;
+      tiers.proxyFree += this->modelClones[i]->model.getStatistics().proxyFree;
+      tiers.exactQueries += this->modelClones[i]->model.getStatistics().exactQueries;
+    }
+    std::cout << "collision tiers: " << tiers.proxyQueries << " proxy queries, " << tiers.proxyFree << " free by proxy, "
+              << tiers.exactQueries << " exact queries" << std::endl;
+  }
+
+  //Occupancy grid: keep what this run learned about the scene for the next one
+  std::cout << "occupancy: " << this->occupancy.getSize() << " cells, "
+            << this->occupancy.getCount(OccupancyGrid::State::FREE) << " free, "
+            << this->occupancy.getCount(OccupancyGrid::State::COLLIDING) << " colliding, "
+            << this->occupancy.getCount(OccupancyGrid::State::MIXED) << " mixed" << std::endl;
+
+  if (!this->occupancyFilename.empty())
+  {
+    this->occupancy.save(this->occupancyFilename, this->getSceneHash(), this->model.getDof());
+  }
+
   return solved;
 }
 
 void TutorialPlanSystem::reset()
 {
-  //Reset the planner and the model
-  this->planner.reset();
+  //Reset the planners and the model, the PRM keeps its roadmap
+  this->planner->reset();
+  this->base.reset();
+  this->prm.reset();
   this->model.reset();
 }
 
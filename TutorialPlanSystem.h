@@ -15,11 +15,23 @@
 //#include "YourPlanner.h"
 #include "YourPlanner.h"
 #include "YourSampler.h"
+#include "BatchKinematics.h"
+#include "CachedVerifier.h"
+#include "ContinuousVerifier.h"
+#include "OccupancyModel.h"
+#include "ParallelShortcutOptimizer.h"
+#include "PrmPlanner.h"
+#include "SamplePool.h"
+#include "SampleStream.h"
 
 class TutorialPlanSystem
 {
 public:
-  TutorialPlanSystem(rl::plan::DistributionType distType = rl::plan::DistributionType::NORMAL);
+  TutorialPlanSystem(
+    rl::plan::DistributionType distType = rl::plan::DistributionType::NORMAL,
+    const std::string& sceneFilename = "../xml/rlsg/unimation-puma560-rbo_wall.xml",
+    const std::string& kinematicsFilename = "../xml/rlkin/unimation-puma560.xml"
+  );
   virtual ~TutorialPlanSystem();
 
   rl::math::Vector& getGoalConfiguration() {return goal;}
@@ -36,7 +48,84 @@ public:
 
   void writeToFile(rl::plan::VectorList & path);
 
-  void setViewer(rl::plan::Viewer* viewer) {this->planner.viewer = viewer;this->optimizer.viewer=viewer;}
+  void setDistributionType(rl::plan::DistributionType distType);
+
+  //  Hash of the scene and kinematics XML files, tags precomputed sample pools.
+  std::uint64_t getSceneHash() const;
+
+  //  Map a precomputed pool of collision-free configurations for this scene.
+  //  Stale or missing pools are rejected and sampling stays live.
+  bool loadSamplePool(const std::string& filename);
+
+  //  Deterministic mode: one seed drives the sampler and the planner engines,
+  //  both are reseeded at the start of every plan() call.
+  void setSeed(std::mt19937::result_type seed);
+
+  //  Record the planner's sample stream to a binary file, or replay one.
+  bool recordSamples(const std::string& filename);
+  bool replaySamples(const std::string& filename);
+
+  void setViewer(rl::plan::Viewer* viewer) {this->planner->viewer = viewer;this->prm.viewer = viewer;this->base.viewer = viewer;this->optimizer.viewer=viewer;}
+
+  //  Select the planner used by plan(): "rrt" (YourPlanner), "base" (plain RrtConConBase), "prm" or "lazyprm".
+  //  "rrt:POLICIES" recreates YourPlanner for a policy combination, e.g. "rrt:goalbias+weighted".
+  bool setPlanner(const std::string& name);
+
+  //  Keep refining the RRT path for seconds after the first solution (0 = off).
+  void setAnytime(double seconds);
+
+  //  Weights of the RRT's weighted metric: "kinematic" (workspace sweep per joint, estimated
+  //  on first use and cached in the working directory) or "linear" (the default).
+  bool setJointWeights(const std::string& name);
+
+  //  Try the k nearest vertices when connecting the other RRT tree (1 = nearest only).
+  void setConnectCandidates(std::size_t k);
+
+  //  Check only the body pairs that can collide, most frequently colliding first,
+  //  instead of the full scene (off by default).
+  void setPairFilter(bool filter);
+
+  //  Reject RRT samples and first connect steps within delta of a known collision without a query (off by default).
+  void setCollisionIndex(bool collisionIndex);
+
+  //  Keep the RRT trees between plan() calls and graft a moved start/goal onto them.
+  void setWarmStart(bool warmStart);
+
+  //  Forward kinematics of edge checks: "batch" (a block of steps per pass,
+  //  specialized for the 6-DOF chain) or "single" (the RL kinematics per step).
+  bool setForwardKinematics(const std::string& name);
+
+  //  Command-line option without the leading "--", shared by tutorialPlan and headlessPlan:
+  //  sampler NAME, start/goal DEGREES (comma separated), seed N, record/replay FILE,
+  //  pool FILE, planner NAME, roadmap FILE, anytime SECONDS, fk batch|single,
+  //  edges discrete|continuous, proxy FILE|off, occupancy FILE, connect-k K, pair-filter on|off, collision-index on|off,
+  //  weights kinematic|linear, warm-start on|off, optimizer advanced|parallel, counters on|off.
+  bool setOption(const std::string& name, const std::string& value);
+
+  //  Read cycles, instructions, cache and branch misses around nearest, connect
+  //  and collision queries. Needs a PLANNER_PROFILE build and perf events.
+  bool setHardwareCounters(bool counters);
+
+  //  Edge checking of the RRT, the optimizers and the PRM: "discrete" (a query
+  //  every delta) or "continuous" (conservative advancement over the segment).
+  //  Continuous edges are refused if the joint radii could not be derived from the kinematics.
+  bool setEdgeChecking(const std::string& name);
+
+  //  Shortcut the solution with the parallel optimizer instead of the AdvancedOptimizer.
+  //  Off by default: its path length against the AdvancedOptimizer has not been benchmarked yet.
+  void setParallelOptimizer(bool parallel) {useParallelOptimizer = parallel;}
+
+  //  Check collisions against the conservative proxy scene in filename first,
+  //  an empty filename checks only the exact scene. A proxy that is free in a random
+  //  configuration where the exact scene collides is refused.
+  bool setProxyScene(const std::string& filename);
+
+  //  Load the occupancy grid from filename if it exists and save it there after every plan().
+  //  Also lets the RRT reject samples in known colliding cells, except in seeded or replayed runs.
+  void setOccupancyFile(const std::string& filename);
+
+  //  Load the PRM roadmap from filename if it exists and save it there after every plan().
+  void setRoadmapFile(const std::string& filename);
 
   bool plan(rl::plan::VectorList &);
 
@@ -46,11 +135,48 @@ public:
 
 private:
 
+  //  Independent collision model for an optimizer worker thread
+  struct ModelClone
+  {
+    std::shared_ptr<rl::kin::Kinematics> kinematics;
+    std::shared_ptr<rl::sg::bullet::Scene> scene;
+    OccupancyModel model;
+    std::shared_ptr<rl::sg::bullet::Scene> proxyScene;
+    rl::plan::DistanceModel proxy;
+  };
+
+  void applySeed();
+
+  //  Sets the parameters of planner, used for every planner the factory creates.
+  void configurePlanner();
+
+  //  Reads the cached joint weights for the kinematics file or estimates and caches them.
+  void loadJointWeights();
+
+  //  Loads the scene and kinematics files into model, the returned scene is owned by the caller.
+  rl::sg::bullet::Scene* loadModel(rl::plan::DistanceModel& model, std::shared_ptr<rl::kin::Kinematics>& kinematics) const;
+
+  //  Loads the proxy scene for model, sharing its kinematics, the returned scene is owned by the caller.
+  rl::sg::bullet::Scene* loadProxy(TwoTierModel& model, rl::plan::DistanceModel& proxy) const;
+
+  //  Makes sure the parallel optimizer has count worker models.
+  void createModelClones(std::size_t count);
+
+  std::string sceneFilename; //collision scene loaded into bullet
+  std::string kinematicsFilename; //robot kinematics
+  std::string proxyFilename; //conservative proxy of the collision scene, empty if not used
+
   rl::math::Vector goal; //goal configuration
   rl::math::Vector start; //start configuration
   rl::math::Vector q; //current configuration
 
-  rl::plan::DistanceModel model; //model for computation
+  OccupancyModel model; //model for computation, records every collision query in occupancy
+
+  std::shared_ptr<rl::sg::bullet::Scene> proxyScene; //proxy scene of model
+  rl::plan::DistanceModel proxyModel; //first tier of model's collision checks
+
+  OccupancyGrid occupancy; //Joint-space cells known free, colliding or mixed
+  std::string occupancyFilename; //Persisted occupancy grid, empty if not persisted
 
   std::shared_ptr<rl::kin::Kinematics> kinematics; //kinematics shared pointer to keep alive
 
@@ -58,10 +184,43 @@ private:
 
   rl::plan::AdvancedOptimizer optimizer; //Trajectory length optimizer
   rl::plan::RecursiveVerifier verifier; //The verifier for the optimizer
+  CachedVerifier cachedVerifier; //Remembers the segments verifier already checked
+  ContinuousVerifier continuousVerifier; //Segment checks by conservative advancement
+
+  BatchKinematics batchKinematics; //Forward kinematics of a block of edge steps at once
+  bool useBatchKinematics; //Use batchKinematics for the edge steps of the RRT and the parallel optimizer
+  bool useContinuousEdges; //Check edges with continuousVerifier instead of delta steps
+
+  ParallelShortcutOptimizer parallelOptimizer; //Shortcutting verified in parallel on model clones
+  bool useParallelOptimizer; //Use parallelOptimizer instead of optimizer
+
+  rl::math::Vector jointWeights; //Kinematics-derived weights of the weighted metric
+  bool useKinematicWeights; //Use jointWeights instead of the linear weights
 
-  YourPlanner planner;  //The implementation of your planner
+  std::size_t connectCandidates; //Candidates of the RRT's k-nearest connect
+
+  bool useCollisionIndex; //Reject the RRT's samples next to known collisions
+
+  std::vector< std::shared_ptr<ModelClone> > modelClones; //Worker models of parallelOptimizer
+
+  std::shared_ptr<YourPlanner> planner;  //The implementation of your planner, see YourPlanner::create
+
+  RrtConConBase base; //Plain RRT-Connect, the baseline YourPlanner is compared against
+
+  PrmPlanner prm; //Multi-query roadmap planner, keeps its roadmap across queries
+
+  rl::plan::Planner* solver; //The planner used by plan()
+
+  std::string roadmapFilename; //Persisted PRM roadmap, empty if not persisted
   
   rl::plan::DistributionType distributionType; //Distribution type for sampling
+
+  SampleStream sampleStream; //Record/replay of the chosen samples
+
+  SamplePool samplePool; //Precomputed collision-free configurations
+
+  bool deterministic; //Reseed before every plan() call
+  std::mt19937::result_type seed; //Seed used in deterministic mode
 };
 
 #endif
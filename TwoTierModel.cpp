@@ -0,0 +1,92 @@
+#include "PhaseProfiler.h"
+#include "TwoTierModel.h"
+
+TwoTierModel::TwoTierModel() :
+  CollisionPairModel(),
+  proxy(NULL),
+  statistics()
+{
+}
+
+TwoTierModel::~TwoTierModel()
+{
+}
+
+bool
+TwoTierModel::isColliding()
+{
+  PROFILE_SCOPE(COLLISION);
+
+  if (NULL != this->proxy)
+  {
+    this->updateProxyFrames();
+
+    ++this->statistics.proxyQueries;
+
+    if (!this->proxy->isColliding())
+    {
+      // Counted like a free exact query, so the benchmark totals stay comparable
+      ++this->statistics.proxyFree;
+      ++this->totalQueries;
+      ++this->freeQueries;
+      return false;
+    }
+  }
+
+  ++this->statistics.exactQueries;
+
+  return CollisionPairModel::isColliding();
+}
+
+bool
+TwoTierModel::checkProxy(const ::std::size_t& samples, const ::std::mt19937::result_type& seed)
+{
+  if (NULL == this->proxy)
+  {
+    return true;
+  }
+
+  // Both scenes are asked directly, a pair filter or the query counts must not hide a miss
+  ::rl::sg::SimpleScene* proxyScene = dynamic_cast< ::rl::sg::SimpleScene* >(this->proxy->scene);
+  ::std::mt19937 engine(seed);
+  ::std::uniform_real_distribution< ::rl::math::Real > distribution(0, 1);
+  ::rl::math::Vector minimum = this->getMinimum();
+  ::rl::math::Vector maximum = this->getMaximum();
+  ::rl::math::Vector q(this->getDof());
+
+  for (::std::size_t n = 0; n < samples; ++n)
+  {
+    for (::std::size_t i = 0; i < this->getDof(); ++i)
+    {
+      q(i) = minimum(i) + distribution(engine) * (maximum(i) - minimum(i));
+    }
+
+    this->setPosition(q);
+    this->updateFrames();
+    this->updateProxyFrames();
+
+    if (!proxyScene->isColliding() && this->simpleScene->isColliding())
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void
+TwoTierModel::resetStatistics()
+{
+  this->statistics = Statistics();
+}
+
+void
+TwoTierModel::updateProxyFrames()
+{
+  for (::std::size_t i = 0; i < this->model->getNumBodies(); ++i)
+  {
+    ::rl::math::Transform frame;
+    this->model->getBody(i)->getFrame(frame);
+    this->proxy->model->getBody(i)->setFrame(frame);
+  }
+}
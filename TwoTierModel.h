@@ -0,0 +1,51 @@
+#ifndef _TWO_TIER_MODEL_H_
+#define _TWO_TIER_MODEL_H_
+
+#include "CollisionPairModel.h"
+
+/**
+*	CollisionPairModel that asks a cheap proxy scene first. The proxy geometry
+*	must enclose the exact geometry, then a free proxy means a free robot and
+*	only configurations the proxy finds colliding go to the exact scene.
+*	The proxy shares the kinematics and takes the body frames of this model,
+*	so setPosition() and updateFrames() are only called on this model.
+*/
+class TwoTierModel : public CollisionPairModel
+{
+public:
+  struct Statistics
+  {
+    ::std::size_t proxyQueries;  // queries answered by the proxy scene
+    ::std::size_t proxyFree;     // of those, free without an exact query
+    ::std::size_t exactQueries;  // queries that reached the exact scene
+  };
+
+  TwoTierModel();
+
+  virtual ~TwoTierModel();
+
+  virtual bool isColliding();
+
+  const Statistics& getStatistics() const { return statistics; }
+
+  void resetStatistics();
+
+  /**
+  *	Compares the proxy with the exact scene in samples random configurations,
+  *	false if the proxy is free in one the exact scene finds colliding. The
+  *	statistics are not touched, the model is left at an arbitrary configuration.
+  */
+  bool checkProxy(const ::std::size_t& samples, const ::std::mt19937::result_type& seed = 0);
+
+  /** Conservative proxy of this model's scene with the same bodies, NULL checks only the exact scene */
+  rl::plan::DistanceModel* proxy;
+
+protected:
+  Statistics statistics;
+
+private:
+  /** Moves the proxy bodies to the frames updateFrames() computed for this model */
+  void updateProxyFrames();
+};
+
+#endif // _TWO_TIER_MODEL_H_
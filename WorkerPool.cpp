@@ -0,0 +1,98 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool() :
+  mutex(),
+  started(),
+  finished(),
+  generation(0),
+  count(0),
+  pending(0),
+  job(NULL),
+  stopping(false),
+  threads()
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+  {
+    ::std::lock_guard< ::std::mutex > lock(this->mutex);
+    this->stopping = true;
+  }
+
+  this->started.notify_all();
+
+  for (::std::size_t i = 0; i < this->threads.size(); ++i)
+  {
+    this->threads[i].join();
+  }
+}
+
+void
+WorkerPool::run(const ::std::size_t& count, const ::std::function< void(const ::std::size_t&) >& job)
+{
+  if (count < 2)
+  {
+    if (1 == count)
+    {
+      job(0);
+    }
+
+    return;
+  }
+
+  {
+    ::std::lock_guard< ::std::mutex > lock(this->mutex);
+
+    // A worker started here waits for the lock and then sees the new generation
+    while (this->threads.size() + 1 < count)
+    {
+      this->threads.push_back(::std::thread(&WorkerPool::work, this, this->threads.size() + 1));
+    }
+
+    this->job = &job;
+    this->count = count;
+    this->pending = count - 1;
+    ++this->generation;
+  }
+
+  this->started.notify_all();
+
+  job(0);
+
+  ::std::unique_lock< ::std::mutex > lock(this->mutex);
+  this->finished.wait(lock, [this]() { return 0 == this->pending; });
+  this->job = NULL;
+}
+
+void
+WorkerPool::work(const ::std::size_t index)
+{
+  ::std::unique_lock< ::std::mutex > lock(this->mutex);
+  ::std::size_t seen = this->generation - 1;
+
+  while (true)
+  {
+    this->started.wait(lock, [this, &seen]() { return this->stopping || this->generation != seen; });
+
+    if (this->stopping)
+    {
+      return;
+    }
+
+    seen = this->generation;
+
+    if (index < this->count)
+    {
+      const ::std::function< void(const ::std::size_t&) >& job = *this->job;
+      lock.unlock();
+      job(index);
+      lock.lock();
+
+      if (0 == --this->pending)
+      {
+        this->finished.notify_one();
+      }
+    }
+  }
+}
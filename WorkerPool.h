@@ -0,0 +1,60 @@
+#ifndef _WORKER_POOL_H_
+#define _WORKER_POOL_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+*	Threads that are started once and kept for repeated parallel jobs, so a
+*	job called thousands of times per plan does not pay for thread creation.
+*	run() hands the job to count - 1 workers, calls it on the calling thread
+*	as well and returns when every call has returned. Workers are added on
+*	demand and joined by the destructor.
+*/
+class WorkerPool
+{
+public:
+  WorkerPool();
+
+  virtual ~WorkerPool();
+
+  /** Calls job(0) on the calling thread and job(1) .. job(count - 1) on the workers */
+  void run(const ::std::size_t& count, const ::std::function< void(const ::std::size_t&) >& job);
+
+  /** Number of worker threads started so far */
+  ::std::size_t getSize() const { return threads.size(); }
+
+protected:
+
+private:
+  /** Loop of the worker with the given index, runs the job of every new generation */
+  void work(const ::std::size_t index);
+
+  ::std::mutex mutex;
+
+  /** Signals a new generation or stopping to the workers */
+  ::std::condition_variable started;
+
+  /** Signals the caller of run() that the last worker returned */
+  ::std::condition_variable finished;
+
+  /** Incremented by every run(), a worker runs each generation once */
+  ::std::size_t generation;
+
+  /** Calls of the current generation, workers with index >= count sit it out */
+  ::std::size_t count;
+
+  /** Worker calls of the current generation that have not returned yet */
+  ::std::size_t pending;
+
+  const ::std::function< void(const ::std::size_t&) >* job;
+
+  bool stopping;
+
+  ::std::vector< ::std::thread > threads;
+};
+
+#endif // _WORKER_POOL_H_
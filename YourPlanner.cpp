@@ -1,16 +1,52 @@
+#include "EventTracer.h"
+#include "PhaseProfiler.h"
 #include "YourPlanner.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
 #include <rl/plan/Sampler.h>
 #include <rl/plan/SimpleModel.h>
 #include <rl/plan/Viewer.h>
 
 YourPlanner::YourPlanner(DistributionType distType) :
   RrtConConBase(),
-  distributionType(distType),
   useDynamicDomain(true),
   useWeightedMetric(true),
   useGoalBias(true),
-  hasBoundaryNodes(false)
+  useAnytime(false),
+  useInformedSampling(true),
+  useWarmStart(false),
+  useCollisionIndex(false),
+  boundaryNodes(2),
+  boundaryRatio(0.5),
+  boundaryRadius(0),
+  minBoundaryRadius(0),
+  boundaryGrowth(1.1),
+  boundaryShrink(0.9),
+  anytimeDuration(::std::chrono::seconds(5)),
+  anytimeIterations(0),
+  rewireRadius(0),
+  graftCandidates(10),
+  connectCandidates(1),
+  connectModels(),
+  collisionIndex(),
+  occupancy(NULL),
+  batch(),
+  continuous(NULL),
+  distributionType(distType),
+  sampledFromSampler(false),
+  reusedVertices(0),
+  domainStatistics(),
+  connectStatistics(),
+  indexStatistics(),
+  edgeStatistics(),
+  bestCost(::std::numeric_limits< ::rl::math::Real >::infinity()),
+  normalDistribution(0, 1),
+  randDistribution(0, 1),
+  randEngine(::std::random_device()())
 {
 }
 
@@ -24,12 +60,125 @@ YourPlanner::getName() const
   return "Your Planner";
 }
 
+namespace
+{
+  template< class Sampling, class Metric, class Domain >
+  ::std::shared_ptr< YourPlanner >
+  createPlanner(DistributionType distType)
+  {
+    return ::std::make_shared< YourPlannerT< Sampling, Metric, Domain > >(distType);
+  }
+}
+
+::std::shared_ptr< YourPlanner >
+YourPlanner::create(const ::std::string& name, DistributionType distType)
+{
+  bool goalBias = false;
+  bool weighted = false;
+  bool dynamicDomain = false;
+
+  ::std::istringstream policies(name);
+  ::std::string policy;
+
+  while (::std::getline(policies, policy, '+'))
+  {
+    if (GoalBiasedSampling::name() == policy)
+    {
+      goalBias = true;
+    }
+    else if (WeightedMetric::name() == policy)
+    {
+      weighted = true;
+    }
+    else if (DynamicDomain::name() == policy)
+    {
+      dynamicDomain = true;
+    }
+    else if (UniformSampling::name() != policy && ModelMetric::name() != policy && NoDomain::name() != policy)
+    {
+      ::std::cout << "unknown planner policy " << policy << ::std::endl;
+      return ::std::shared_ptr< YourPlanner >();
+    }
+  }
+
+  if (goalBias)
+  {
+    if (weighted)
+    {
+      return dynamicDomain ? createPlanner< GoalBiasedSampling, WeightedMetric, DynamicDomain >(distType) : createPlanner< GoalBiasedSampling, WeightedMetric, NoDomain >(distType);
+    }
+
+    return dynamicDomain ? createPlanner< GoalBiasedSampling, ModelMetric, DynamicDomain >(distType) : createPlanner< GoalBiasedSampling, ModelMetric, NoDomain >(distType);
+  }
+
+  if (weighted)
+  {
+    return dynamicDomain ? createPlanner< UniformSampling, WeightedMetric, DynamicDomain >(distType) : createPlanner< UniformSampling, WeightedMetric, NoDomain >(distType);
+  }
+
+  return dynamicDomain ? createPlanner< UniformSampling, ModelMetric, DynamicDomain >(distType) : createPlanner< UniformSampling, ModelMetric, NoDomain >(distType);
+}
+
+void
+YourPlanner::reset()
+{
+  RrtConConBase::reset();
+
+  // Everything below refers to the vertices of the cleared trees
+  this->boundaryNodes[0].clear();
+  this->boundaryNodes[1].clear();
+  this->connections.clear();
+  this->collisionIndex.clear();
+}
+
+void
+YourPlanner::seed(const ::std::mt19937::result_type& value)
+{
+  this->randEngine.seed(value);
+  this->normalDistribution.reset();
+}
+
 void
 YourPlanner::choose(::rl::math::Vector& chosen)
+{
+  // Runtime entry point, solve() calls the compiled combination directly
+  if (useGoalBias)
+  {
+    useDynamicDomain ? this->chooseWith< GoalBiasedSampling, DynamicDomain >(chosen) : this->chooseWith< GoalBiasedSampling, NoDomain >(chosen);
+  }
+  else
+  {
+    useDynamicDomain ? this->chooseWith< UniformSampling, DynamicDomain >(chosen) : this->chooseWith< UniformSampling, NoDomain >(chosen);
+  }
+}
+
+template< class Sampling, class Domain >
+void
+YourPlanner::chooseWith(::rl::math::Vector& chosen)
+{
+  this->sampledFromSampler = false;
+
+  // Replayed samples bypass every strategy so the tree is rebuilt exactly
+  if (NULL != this->sampleStream && this->sampleStream->read(chosen))
+  {
+    return;
+  }
+
+  this->sampleWith< Sampling, Domain >(chosen);
+
+  if (NULL != this->sampleStream)
+  {
+    this->sampleStream->write(chosen);
+  }
+}
+
+template< class Sampling, class Domain >
+void
+YourPlanner::sampleWith(::rl::math::Vector& chosen)
 {
   // --- Extension 3: Goal-biased sampling ---
   // With 5% probability, sample the opposite tree's root to encourage convergence
-  if (useGoalBias && (rand() % 20) == 0)
+  if (Sampling::goalBias && this->randDistribution(this->randEngine) < 0.05)
   {
     if (currentTree == &this->tree[0])
       chosen = *this->goal;   // extending from start -> bias towards goal
@@ -38,44 +187,79 @@ YourPlanner::choose(::rl::math::Vector& chosen)
     return;
   }
 
-  // --- Extension 1: Dynamic-domain bounding-box sampling ---
-  if (useDynamicDomain && hasBoundaryNodes)
+  // --- Extension 1: Dynamic-domain sampling from the union of boundary balls ---
+  // The remaining samples are unrestricted and cover the non-boundary regions
+  const ::std::vector< Vertex >& boundary = this->boundaryNodes[currentTree == &this->tree[0] ? 0 : 1];
+
+  if (Domain::enabled && !boundary.empty() && this->randDistribution(this->randEngine) < boundaryRatio)
   {
-    for (int i = 0; i < chosen.size(); ++i)
-    {
-      ::rl::math::Real t = static_cast<::rl::math::Real>(rand()) / RAND_MAX;
-      chosen[i] = bbMin[i] + t * (bbMax[i] - bbMin[i]);
-    }
+    this->sampleBoundary(*currentTree, boundary, chosen);
   }
   else
   {
     // Baseline: uniform random sample
     chosen = this->sampler->generate();
+    this->sampledFromSampler = true;
   }
 }
 
 void
-YourPlanner::expandBoundingBox(const ::rl::math::Vector& q)
+YourPlanner::sampleBoundary(const Tree& tree, const ::std::vector< Vertex >& boundary, ::rl::math::Vector& chosen)
 {
-  if (!hasBoundaryNodes)
+  ::std::size_t dof = this->model->getDof();
+  ::rl::math::Vector minimum = this->model->getMinimum();
+  ::rl::math::Vector maximum = this->model->getMaximum();
+
+  // Pick a ball proportional to its volume, radius^dof
+  ::std::vector< ::rl::math::Real > volumes(boundary.size());
+  ::rl::math::Real total = 0;
+
+  for (::std::size_t i = 0; i < boundary.size(); ++i)
   {
-    bbMin.resize(q.size());
-    bbMax.resize(q.size());
-    for (int j = 0; j < q.size(); ++j)
-    {
-      bbMin[j] = q[j] - boundaryRadius;
-      bbMax[j] = q[j] + boundaryRadius;
-    }
-    hasBoundaryNodes = true;
+    total += ::std::pow(tree[boundary[i]].radius, static_cast< ::rl::math::Real >(dof));
+    volumes[i] = total;
   }
-  else
+
+  for (int attempts = 0; attempts < 100; ++attempts)
   {
-    for (int j = 0; j < q.size(); ++j)
+    ::std::size_t i = ::std::upper_bound(volumes.begin(), volumes.end(), this->randDistribution(this->randEngine) * total) - volumes.begin();
+    const Vertex& center = boundary[(::std::min)(i, boundary.size() - 1)];
+
+    // Uniform in the ball: random direction, distance scaled by u^(1/dof)
+    for (::std::size_t j = 0; j < dof; ++j)
     {
-      bbMin[j] = std::min(bbMin[j], q[j] - boundaryRadius);
-      bbMax[j] = std::max(bbMax[j], q[j] + boundaryRadius);
+      chosen[j] = this->normalDistribution(this->randEngine);
+    }
+
+    chosen *= tree[center].radius * ::std::pow(this->randDistribution(this->randEngine), static_cast< ::rl::math::Real >(1) / dof) / chosen.norm();
+    chosen += *tree[center].q;
+    ++this->domainStatistics.ballSamples;
+
+    if ((chosen.array() < minimum.array()).any() || (chosen.array() > maximum.array()).any())
+    {
+      continue;
+    }
+
+    // Accepting with 1 / (balls covering the sample) makes the union uniform,
+    // overall acceptance is volume(union within limits) / sum of ball volumes
+    ::std::size_t coverage = 0;
+
+    for (::std::size_t k = 0; k < boundary.size(); ++k)
+    {
+      if (this->model->distance(chosen, *tree[boundary[k]].q) <= tree[boundary[k]].radius)
+      {
+        ++coverage;
+      }
+    }
+
+    if (this->randDistribution(this->randEngine) * coverage < 1)
+    {
+      ++this->domainStatistics.ballAccepted;
+      return;
     }
   }
+
+  this->model->clip(chosen);
 }
 
 RrtConConBase::Vertex
@@ -85,6 +269,7 @@ YourPlanner::addVertex(Tree& tree, const ::rl::plan::VectorPtr& q)
   tree[v].index = ::boost::num_vertices(tree) - 1;
   tree[v].q = q;
   tree[v].radius = std::numeric_limits<::rl::math::Real>::infinity(); // Line 8: non-boundary
+  tree[v].cost = 0;
 
   if (NULL != this->viewer)
   {
@@ -98,65 +283,91 @@ void
 YourPlanner::markBoundary(Tree& tree, const Vertex& v)
 {
   // Line 12: mark node as boundary and expand sampling bbox
-  tree[v].radius = boundaryRadius;
-  expandBoundingBox(*tree[v].q);
+  if (std::isinf(tree[v].radius))
+  {
+    tree[v].radius = boundaryRadius;
+    boundaryNodes[&tree == &this->tree[0] ? 0 : 1].push_back(v);
+  }
+  else
+  {
+    // Adaptive dynamic domain: a failed extension shrinks the boundary ball
+    tree[v].radius = std::max(minBoundaryRadius, tree[v].radius * boundaryShrink);
+    ++domainStatistics.shrunk;
+  }
 }
 
-::rl::math::Real
-YourPlanner::weightedDistance(const ::rl::math::Vector& a, const ::rl::math::Vector& b) const
+void
+YourPlanner::growBoundary(Tree& tree, const Vertex& v)
 {
-  ::rl::math::Real sum = 0.0;
-  for (int i = 0; i < a.size(); ++i)
+  // Adaptive dynamic domain: a successful extension grows the boundary ball
+  if (!std::isinf(tree[v].radius))
   {
-    ::rl::math::Real diff = a[i] - b[i];
-    sum += weights[i] * diff * diff;
+    tree[v].radius *= boundaryGrowth;
+    ++domainStatistics.grown;
   }
-  return std::sqrt(sum);
 }
 
 RrtConConBase::Neighbor
 YourPlanner::nearest(const Tree& tree, const ::rl::math::Vector& chosen)
 {
-  Neighbor p(Vertex(), (::std::numeric_limits<::rl::math::Real>::max)());
-
+  // Runtime entry point, solve() calls the compiled combination directly
   if (useWeightedMetric)
   {
-    // --- Extension 2: Weighted distance metric ---
-    ::rl::math::Real bestWeightedDist = (::std::numeric_limits<::rl::math::Real>::max)();
-
-    for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
-    {
-      ::rl::math::Real wd = weightedDistance(chosen, *tree[*i.first].q);
-      if (wd < bestWeightedDist)
-      {
-        p.first = *i.first;
-        bestWeightedDist = wd;
-        // Store actual model distance for geometric operations
-        p.second = this->model->distance(chosen, *tree[*i.first].q);
-      }
-    }
+    return this->nearestWith< WeightedMetric >(tree, chosen);
   }
-  else
+
+  return this->nearestWith< ModelMetric >(tree, chosen);
+}
+
+template< class Metric >
+RrtConConBase::Neighbor
+YourPlanner::nearestWith(const Tree& tree, const ::rl::math::Vector& chosen)
+{
+  PROFILE_SCOPE(NEAREST);
+
+  // --- Extension 2: the metric kernel is inlined, only the winner gets a model distance ---
+  Neighbor p(Vertex(), (::std::numeric_limits<::rl::math::Real>::max)());
+
+  for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
   {
-    // Baseline: model's transformed distance
-    for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
+    ::rl::math::Real d = Metric::compare(*this->model, this->weights, chosen, *tree[*i.first].q);
+
+    if (d < p.second)
     {
-      ::rl::math::Real d = this->model->transformedDistance(chosen, *tree[*i.first].q);
-      if (d < p.second)
-      {
-        p.first = *i.first;
-        p.second = d;
-      }
+      p.first = *i.first;
+      p.second = d;
     }
-    p.second = this->model->inverseOfTransformedDistance(p.second);
   }
 
+  p.second = Metric::distance(*this->model, chosen, *tree[p.first].q, p.second);
+
   return p;
 }
 
 RrtConConBase::Vertex
 YourPlanner::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen)
 {
+  // Runtime entry point, solve() calls the compiled combination directly
+  if (useDynamicDomain)
+  {
+    return this->connectWith< DynamicDomain >(tree, nearest, chosen);
+  }
+
+  return this->connectWith< NoDomain >(tree, nearest, chosen);
+}
+
+template< class Domain >
+RrtConConBase::Vertex
+YourPlanner::connectWith(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen)
+{
+  PROFILE_SCOPE(CONNECT);
+
+  // --- Extension 9: one continuous check instead of a query every delta ---
+  if (NULL != this->continuous)
+  {
+    return this->connectContinuousWith< Domain >(tree, nearest, chosen);
+  }
+
   ::rl::math::Real distance = nearest.second;
   ::rl::math::Real step = distance;
   bool reached = false;
@@ -172,48 +383,122 @@ YourPlanner::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vect
 
   ::rl::plan::VectorPtr last = ::std::make_shared<::rl::math::Vector>(this->model->getDof());
   this->model->interpolate(*tree[nearest.first].q, chosen, step / distance, *last);
-  this->model->setPosition(*last);
-  this->model->updateFrames();
 
-  if (this->model->isColliding())
+  // --- Extension 7: a first step next to a known collision costs no query ---
+  bool colliding = useCollisionIndex && this->collisionIndex.contains(*last);
+
+  if (colliding)
+  {
+    ++this->indexStatistics.avoidedQueries;
+  }
+  else
+  {
+    this->model->setPosition(*last);
+    {
+      PROFILE_SCOPE(KINEMATICS);
+      this->model->updateFrames();
+    }
+    colliding = this->model->isColliding();
+
+    if (colliding && useCollisionIndex)
+    {
+      this->collisionIndex.insert(*last);
+    }
+  }
+
+  if (colliding)
   {
     // --- Extension 1: mark boundary on collision ---
-    if (useDynamicDomain)
+    if (Domain::enabled)
       markBoundary(tree, nearest.first);
     return NULL;
   }
 
-  ::rl::math::Vector next(this->model->getDof());
+  if (Domain::enabled)
+  {
+    growBoundary(tree, nearest.first);
+  }
 
-  while (!reached)
+  if (!reached)
   {
-    distance = this->model->distance(*last, chosen);
-    step = distance;
+    // The remaining steps lie at multiples of delta along the segment, the last
+    // one at chosen, their frames are computed a block at a time
+    ::std::size_t steps = static_cast< ::std::size_t >(::std::ceil(distance / this->delta));
+    ::std::vector< ::rl::math::Real > alphas;
 
-    if (step <= this->delta)
+    for (::std::size_t i = 2; i <= steps; ++i)
     {
-      reached = true;
-    }
-    else
-    {
-      step = this->delta;
+      alphas.push_back((::std::min)(i * this->delta / distance, static_cast< ::rl::math::Real >(1)));
     }
 
-    this->model->interpolate(*last, chosen, step / distance, next);
-    this->model->setPosition(next);
-    this->model->updateFrames();
+    ::std::size_t queries = 0;
+    ::std::size_t colliding = this->batch.firstCollision(this->model, *tree[nearest.first].q, chosen, alphas, queries);
 
-    if (this->model->isColliding())
+    if (colliding < alphas.size())
     {
-      // --- Extension 1: mark boundary on collision ---
-      if (useDynamicDomain)
+      if (useCollisionIndex)
+      {
+        ::rl::math::Vector next(this->model->getDof());
+        this->model->interpolate(*tree[nearest.first].q, chosen, alphas[colliding], next);
+        this->collisionIndex.insert(next);
+      }
+
+      // --- Extension 1: mark boundary on collision, the extension itself succeeded ---
+      if (Domain::enabled && std::isinf(tree[nearest.first].radius))
         markBoundary(tree, nearest.first);
-      break;
     }
 
-    *last = next;
+    if (colliding > 0)
+    {
+      this->model->interpolate(*tree[nearest.first].q, chosen, alphas[colliding - 1], *last);
+    }
+  }
+
+  Vertex connected = this->addVertex(tree, last);
+  this->addEdge(nearest.first, connected, tree);
+  return connected;
+}
+
+template< class Domain >
+RrtConConBase::Vertex
+YourPlanner::connectContinuousWith(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen)
+{
+  ::rl::math::Real distance = nearest.second;
+  ::rl::math::Real contact = 1;
+  ::std::size_t queries = 0;
+  bool free = this->continuous->advance(this->model, *tree[nearest.first].q, chosen, contact, queries);
+
+  ++this->edgeStatistics.edges;
+  this->edgeStatistics.queries += queries;
+
+  // Stay a delta short of the contact, like the last free step of connectWith()
+  ::rl::math::Real reach = free ? distance : contact * distance - this->delta;
+
+  if (!free)
+  {
+    ++this->edgeStatistics.contacts;
+  }
+
+  if (reach <= 0)
+  {
+    // --- Extension 1: mark boundary on collision ---
+    if (Domain::enabled)
+      markBoundary(tree, nearest.first);
+    return NULL;
   }
 
+  if (Domain::enabled)
+  {
+    growBoundary(tree, nearest.first);
+
+    // --- Extension 1: mark boundary on collision, the extension itself succeeded ---
+    if (!free && std::isinf(tree[nearest.first].radius))
+      markBoundary(tree, nearest.first);
+  }
+
+  ::rl::plan::VectorPtr last = ::std::make_shared<::rl::math::Vector>(this->model->getDof());
+  this->model->interpolate(*tree[nearest.first].q, chosen, reach / distance, *last);
+
   Vertex connected = this->addVertex(tree, last);
   this->addEdge(nearest.first, connected, tree);
   return connected;
@@ -222,15 +507,56 @@ YourPlanner::connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vect
 bool
 YourPlanner::solve()
 {
+  // Pick the compiled combination once, the planning loop has no runtime switches
+  if (useGoalBias)
+  {
+    if (useWeightedMetric)
+    {
+      return useDynamicDomain ? this->solveWith< GoalBiasedSampling, WeightedMetric, DynamicDomain >() : this->solveWith< GoalBiasedSampling, WeightedMetric, NoDomain >();
+    }
+
+    return useDynamicDomain ? this->solveWith< GoalBiasedSampling, ModelMetric, DynamicDomain >() : this->solveWith< GoalBiasedSampling, ModelMetric, NoDomain >();
+  }
+
+  if (useWeightedMetric)
+  {
+    return useDynamicDomain ? this->solveWith< UniformSampling, WeightedMetric, DynamicDomain >() : this->solveWith< UniformSampling, WeightedMetric, NoDomain >();
+  }
+
+  return useDynamicDomain ? this->solveWith< UniformSampling, ModelMetric, DynamicDomain >() : this->solveWith< UniformSampling, ModelMetric, NoDomain >();
+}
+
+template< class Sampling, class Metric, class Domain >
+bool
+YourPlanner::solveWith()
+{
+  // --- Extension 5: Warm start, reuse the trees of the previous solve() ---
+  bool warm = useWarmStart && NULL != this->begin[0] && NULL != this->begin[1];
+
   // --- Extension 1: Dynamic-domain init ---
-  if (useDynamicDomain)
+  if (Domain::enabled && !warm)
   {
-    boundaryRadius = 15.0 * this->delta;    // adjust this param
-    hasBoundaryNodes = false;
+    if (boundaryRadius <= 0)
+    {
+      boundaryRadius = 15.0 * this->delta;    // adjust this param
+    }
+
+    if (minBoundaryRadius <= 0)
+    {
+      minBoundaryRadius = this->delta;
+    }
+
+    boundaryNodes[0].clear();
+    boundaryNodes[1].clear();
   }
 
+  this->domainStatistics = DomainStatistics();
+  this->connectStatistics = ConnectStatistics();
+  this->indexStatistics = IndexStatistics();
+  this->edgeStatistics = EdgeStatistics();
+
   // --- Extension 2: Weighted metric init ---
-  if (useWeightedMetric)
+  if (Metric::weighted && weights.size() != static_cast< ::std::ptrdiff_t >(this->model->getDof()))
   {
     std::size_t dof = this->model->getDof();
     weights.resize(dof);
@@ -241,9 +567,59 @@ YourPlanner::solve()
     }
   }
 
+  // Narrow-passage statistics: credit connected vertices to the sampler mode
+  YourSampler* yourSampler = dynamic_cast< YourSampler* >(this->sampler);
+
+  // --- Extension 4: Anytime init ---
+  if (!warm)
+  {
+    this->connections.clear();
+  }
+
+  this->costHistory.clear();
+  this->bestCost = ::std::numeric_limits< ::rl::math::Real >::infinity();
+  {
+    ::std::lock_guard< ::std::mutex > lock(this->bestMutex);
+    this->bestPath.clear();
+  }
+
+  if (useAnytime && this->rewireRadius <= 0)
+  {
+    this->rewireRadius = 10.0 * this->delta;
+  }
+
+  bool solved = false;
+  ::std::chrono::steady_clock::time_point solvedTime;
+  ::std::size_t iterations = 0;
+
   this->time = ::std::chrono::steady_clock::now();
-  this->begin[0] = this->addVertex(this->tree[0], ::std::make_shared<::rl::math::Vector>(*this->start));
-  this->begin[1] = this->addVertex(this->tree[1], ::std::make_shared<::rl::math::Vector>(*this->goal));
+  this->reusedVertices = 0;
+
+  if (warm)
+  {
+    // --- Extension 5: graft start and goal, the old connection may still hold ---
+    if (this->replan())
+    {
+      if (!useAnytime)
+      {
+        return true;
+      }
+
+      if (this->connections.empty())
+      {
+        this->connections.push_back(::std::make_pair(this->end[0], this->end[1]));
+      }
+
+      solved = true;
+      solvedTime = ::std::chrono::steady_clock::now();
+      this->updateBest();
+    }
+  }
+  else
+  {
+    this->begin[0] = this->addVertex(this->tree[0], ::std::make_shared<::rl::math::Vector>(*this->start));
+    this->begin[1] = this->addVertex(this->tree[1], ::std::make_shared<::rl::math::Vector>(*this->goal));
+  }
 
   Tree* a = &this->tree[0];
   Tree* b = &this->tree[1];
@@ -252,55 +628,483 @@ YourPlanner::solve()
 
   while ((::std::chrono::steady_clock::now() - this->time) < this->duration)
   {
+    // --- Extension 4: stop refining once the anytime budget is spent ---
+    if (solved)
+    {
+      if ((::std::chrono::steady_clock::now() - solvedTime) >= this->anytimeDuration ||
+          (this->anytimeIterations > 0 && iterations >= this->anytimeIterations))
+      {
+        break;
+      }
+
+      ++iterations;
+    }
+
     for (::std::size_t j = 0; j < 2; ++j)
     {
       Neighbor aNearest;
 
-      if (useDynamicDomain)
+      if (Domain::enabled)
       {
         // --- Extension 1: Rejection sampling from dynamic domain ---
         int attempts = 0;
+        bool rejected = false;
         do
         {
           currentTree = a; 
-          this->choose(chosen);
-          aNearest = this->nearest(*a, chosen);
+          this->chooseInformedWith< Sampling, Domain >(chosen);
+          aNearest = this->nearestWith< Metric >(*a, chosen);
           ++attempts;
+          PROFILE_COUNT(REJECTION);
+          rejected = (*a)[aNearest.first].radius != std::numeric_limits<::rl::math::Real>::infinity()
+                     && aNearest.second > (*a)[aNearest.first].radius;
+          ++this->domainStatistics.samples;
+          this->domainStatistics.rejected += rejected ? 1 : 0;
         }
-        while ((*a)[aNearest.first].radius != std::numeric_limits<::rl::math::Real>::infinity()
-               && aNearest.second > (*a)[aNearest.first].radius
-               && attempts < 30); // adjust this param
+        while (rejected && attempts < 30); // adjust this param
       }
       else
       {
         // Baseline: single sample, no rejection
         currentTree = a;
-        this->choose(chosen);
-        aNearest = this->nearest(*a, chosen);
+        this->chooseInformedWith< Sampling, Domain >(chosen);
+        aNearest = this->nearestWith< Metric >(*a, chosen);
       }
 
-      Vertex aConnected = this->connect(*a, aNearest, chosen);
+      Vertex aConnected = this->connectWith< Domain >(*a, aNearest, chosen);
 
       if (NULL != aConnected)
       {
-        Neighbor bNearest = this->nearest(*b, *(*a)[aConnected].q);
-        Vertex bConnected = this->connect(*b, bNearest, *(*a)[aConnected].q);
+        if (NULL != yourSampler && this->sampledFromSampler)
+        {
+          yourSampler->addVertices();
+        }
+
+        if (useAnytime)
+        {
+          this->rewire(*a, aConnected);
+        }
+
+        Vertex bConnected = this->connectTreeWith< Metric, Domain >(*b, *(*a)[aConnected].q);
 
         if (NULL != bConnected)
         {
+          if (useAnytime)
+          {
+            this->rewire(*b, bConnected);
+          }
+
           if (this->areEqual(*(*a)[aConnected].q, *(*b)[bConnected].q))
           {
-            this->end[0] = &this->tree[0] == a ? aConnected : bConnected;
-            this->end[1] = &this->tree[1] == b ? bConnected : aConnected;
-            return true;
+            Vertex end0 = &this->tree[0] == a ? aConnected : bConnected;
+            Vertex end1 = &this->tree[1] == b ? bConnected : aConnected;
+            EventTracer::instant("planner", "trees connected");
+
+            if (!useAnytime)
+            {
+              this->end[0] = end0;
+              this->end[1] = end1;
+              return true;
+            }
+
+            // --- Extension 4: keep the connection and continue refining, updateBest() picks end ---
+            this->connections.push_back(::std::make_pair(end0, end1));
+
+            if (!solved)
+            {
+              solved = true;
+              solvedTime = ::std::chrono::steady_clock::now();
+            }
           }
         }
       }
 
+      if (solved)
+      {
+        this->updateBest();
+      }
+
       using ::std::swap;
       swap(a, b);
     }
   }
 
-  return false;
-}
\ No newline at end of file
+  return solved;
+}
+
+template< class Sampling, class Domain >
+void
+YourPlanner::chooseInformedWith(::rl::math::Vector& chosen)
+{
+  PROFILE_SCOPE(CHOOSE);
+
+  // Informed sampling: a sample can only shorten the best path if the
+  // straight-line detour start -> sample -> goal is shorter than it.
+  for (int attempts = 0; attempts < 100; ++attempts)
+  {
+    this->chooseWith< Sampling, Domain >(chosen);
+
+    // --- Extension 7: skip samples next to a configuration that already collided ---
+    if (useCollisionIndex && attempts + 1 < 100 && this->collisionIndex.contains(chosen))
+    {
+      ++this->indexStatistics.rejectedSamples;
+      continue;
+    }
+
+    // --- Extension 8: samples in cells known to collide are rejected for free ---
+    if (NULL != this->occupancy && attempts + 1 < 100 && this->occupancy->isColliding(chosen))
+    {
+      ++this->indexStatistics.occupiedSamples;
+      continue;
+    }
+
+    if (!useInformedSampling || ::std::isinf(this->bestCost) ||
+        this->model->distance(*this->start, chosen) + this->model->distance(chosen, *this->goal) < this->bestCost)
+    {
+      return;
+    }
+  }
+}
+
+bool
+YourPlanner::isFree(const ::rl::math::Vector& a, const ::rl::math::Vector& b)
+{
+  ::std::size_t queries = 0;
+  return this->isFree(this->model, a, b, queries);
+}
+
+bool
+YourPlanner::isFree(::rl::plan::SimpleModel* model, const ::rl::math::Vector& a, const ::rl::math::Vector& b, ::std::size_t& queries) const
+{
+  if (NULL != this->continuous)
+  {
+    ::rl::math::Real contact = 0;
+    return this->continuous->advance(model, a, b, contact, queries);
+  }
+
+  ::rl::math::Real distance = model->distance(a, b);
+  ::std::size_t steps = static_cast< ::std::size_t >(::std::ceil(distance / this->delta));
+  ::std::vector< ::rl::math::Real > alphas;
+
+  // Both endpoints are tree vertices and known to be free
+  for (::std::size_t i = 1; i < steps; ++i)
+  {
+    alphas.push_back(static_cast< ::rl::math::Real >(i) / steps);
+  }
+
+  return this->batch.firstCollision(model, a, b, alphas, queries) == alphas.size();
+}
+
+template< class Metric >
+void
+YourPlanner::kNearestWith(const Tree& tree, const ::rl::math::Vector& chosen, const ::std::size_t& k, ::std::vector< Neighbor >& neighbors)
+{
+  PROFILE_SCOPE(NEAREST);
+
+  neighbors.clear();
+
+  for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
+  {
+    neighbors.push_back(Neighbor(*i.first, Metric::compare(*this->model, this->weights, chosen, *tree[*i.first].q)));
+  }
+
+  ::std::size_t count = (::std::min)(k, neighbors.size());
+  ::std::partial_sort(neighbors.begin(), neighbors.begin() + count, neighbors.end(), [](const Neighbor& lhs, const Neighbor& rhs) { return lhs.second < rhs.second; });
+  neighbors.resize(count);
+
+  for (::std::size_t i = 0; i < neighbors.size(); ++i)
+  {
+    neighbors[i].second = Metric::distance(*this->model, chosen, *tree[neighbors[i].first].q, neighbors[i].second);
+  }
+}
+
+template< class Metric, class Domain >
+RrtConConBase::Vertex
+YourPlanner::connectTreeWith(Tree& tree, const ::rl::math::Vector& target)
+{
+  if (this->connectCandidates <= 1)
+  {
+    return this->connectWith< Domain >(tree, this->nearestWith< Metric >(tree, target), target);
+  }
+
+  // --- Extension 6: k-nearest connect, the nearest vertex first as usual ---
+  ::std::vector< Neighbor > candidates;
+  this->kNearestWith< Metric >(tree, target, this->connectCandidates, candidates);
+  ++this->connectStatistics.attempts;
+
+  Vertex connected = this->connectWith< Domain >(tree, candidates.front(), target);
+
+  if (NULL != connected && this->areEqual(*tree[connected].q, target))
+  {
+    ++this->connectStatistics.nearest;
+    return connected;
+  }
+
+  // The nearest vertex got stuck, take the nearest further candidate with a free segment
+  candidates.erase(candidates.begin());
+  ::std::size_t rank = this->firstFree(tree, candidates, target);
+
+  if (rank < candidates.size())
+  {
+    ++this->connectStatistics.others;
+    Vertex reached = this->addVertex(tree, ::std::make_shared<::rl::math::Vector>(target));
+    this->addEdge(candidates[rank].first, reached, tree);
+    return reached;
+  }
+
+  return connected;
+}
+
+::std::size_t
+YourPlanner::firstFree(const Tree& tree, const ::std::vector< Neighbor >& candidates, const ::rl::math::Vector& target)
+{
+  ::std::atomic< ::std::size_t > best(candidates.size());
+  ::std::atomic< ::std::size_t > next(0);
+  ::std::atomic< ::std::size_t > queries(0);
+
+  // Candidates are taken in order, a worker skips those ranked behind a success
+  auto worker = [&](::rl::plan::SimpleModel* model)
+  {
+    ::std::size_t checked = 0;
+
+    for (::std::size_t k = next++; k < best; k = next++)
+    {
+      if (this->isFree(model, *tree[candidates[k].first].q, target, checked))
+      {
+        ::std::size_t current = best;
+
+        while (k < current && !best.compare_exchange_weak(current, k))
+        {
+        }
+      }
+    }
+
+    queries += checked;
+  };
+
+  // Worker 0 is the calling thread on model, the others run on the persistent pool
+  ::std::size_t workers = ::std::max< ::std::size_t >(1, ::std::min(this->connectModels.size(), candidates.size()));
+
+  this->connectPool.run(workers, [&](const ::std::size_t& i)
+  {
+    worker(0 == i ? this->model : this->connectModels[i]);
+  });
+
+  this->connectStatistics.extraQueries += queries;
+
+  return best;
+}
+
+void
+YourPlanner::rewire(Tree& tree, const Vertex& v)
+{
+  ::std::vector< Neighbor > neighbors;
+  this->near(tree, *tree[v].q, this->rewireRadius, neighbors);
+
+  // Choose the parent that gives v the cheapest collision-free path to the root
+  Vertex parent = ::boost::source(*::boost::in_edges(v, tree).first, tree);
+  Vertex best = parent;
+  ::rl::math::Real cost = tree[v].cost;
+
+  for (::std::size_t i = 0; i < neighbors.size(); ++i)
+  {
+    const Vertex& n = neighbors[i].first;
+    ::rl::math::Real c = tree[n].cost + neighbors[i].second;
+
+    if (n != v && n != parent && c < cost && this->isFree(*tree[n].q, *tree[v].q))
+    {
+      best = n;
+      cost = c;
+    }
+  }
+
+  if (best != parent)
+  {
+    ::boost::remove_edge(parent, v, tree);
+    this->addEdge(best, v, tree);
+  }
+
+  // Reroute neighbours whose path to the root gets shorter through v
+  for (::std::size_t i = 0; i < neighbors.size(); ++i)
+  {
+    const Vertex& n = neighbors[i].first;
+
+    if (n == v || n == best || 0 == ::boost::in_degree(n, tree))
+    {
+      continue;
+    }
+
+    if (tree[v].cost + neighbors[i].second < tree[n].cost && this->isFree(*tree[v].q, *tree[n].q))
+    {
+      ::boost::remove_edge(*::boost::in_edges(n, tree).first, tree);
+      this->addEdge(v, n, tree);
+      this->updateCosts(tree, n);
+    }
+  }
+}
+
+void
+YourPlanner::updateCosts(Tree& tree, const Vertex& v)
+{
+  ::std::vector< Vertex > stack(1, v);
+
+  while (!stack.empty())
+  {
+    Vertex u = stack.back();
+    stack.pop_back();
+
+    for (::boost::graph_traits< Tree >::out_edge_iterator e = ::boost::out_edges(u, tree).first; e != ::boost::out_edges(u, tree).second; ++e)
+    {
+      Vertex w = ::boost::target(*e, tree);
+      tree[w].cost = tree[u].cost + this->model->distance(*tree[u].q, *tree[w].q);
+      stack.push_back(w);
+    }
+  }
+}
+
+void
+YourPlanner::updateBest()
+{
+  // Rewiring lowers the costs of earlier connections too, so compare all of them
+  ::rl::math::Real cost = ::std::numeric_limits< ::rl::math::Real >::infinity();
+  ::std::size_t best = 0;
+
+  for (::std::size_t i = 0; i < this->connections.size(); ++i)
+  {
+    ::rl::math::Real c = this->tree[0][this->connections[i].first].cost + this->tree[1][this->connections[i].second].cost;
+
+    if (c < cost)
+    {
+      cost = c;
+      best = i;
+    }
+  }
+
+  if (this->connections.empty())
+  {
+    return;
+  }
+
+  // end always marks the cheapest connection, so getPath() returns the best path
+  this->end[0] = this->connections[best].first;
+  this->end[1] = this->connections[best].second;
+
+  if (cost < this->bestCost)
+  {
+    this->bestCost = cost;
+
+    this->costHistory.push_back(::std::make_pair(
+      ::std::chrono::duration_cast< ::std::chrono::duration< ::rl::math::Real, ::std::milli > >(::std::chrono::steady_clock::now() - this->time).count(),
+      cost
+    ));
+
+    rl::plan::VectorList path = this->getPath();
+    ::std::lock_guard< ::std::mutex > lock(this->bestMutex);
+    this->bestPath.swap(path);
+  }
+}
+
+::rl::plan::VectorList
+YourPlanner::getBestPath()
+{
+  ::std::lock_guard< ::std::mutex > lock(this->bestMutex);
+  return this->bestPath;
+}
+bool
+YourPlanner::graft(Tree& tree, Vertex& root, const ::rl::math::Vector& q)
+{
+  if (this->areEqual(*tree[root].q, q))
+  {
+    return true;
+  }
+
+  ::std::vector< Neighbor > candidates;
+
+  for (VertexIteratorPair i = ::boost::vertices(tree); i.first != i.second; ++i.first)
+  {
+    candidates.push_back(Neighbor(*i.first, this->model->distance(q, *tree[*i.first].q)));
+  }
+
+  ::std::size_t k = (::std::min)(this->graftCandidates, candidates.size());
+  ::std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end(), [](const Neighbor& lhs, const Neighbor& rhs) { return lhs.second < rhs.second; });
+
+  // The nearest vertex with a free segment to q becomes its only child
+  Vertex n = NULL;
+
+  for (::std::size_t i = 0; i < k && NULL == n; ++i)
+  {
+    if (this->isFree(q, *tree[candidates[i].first].q))
+    {
+      n = candidates[i].first;
+    }
+  }
+
+  if (NULL == n)
+  {
+    return false;
+  }
+
+  // Reverse the edges from n up to the old root, so the whole tree hangs below n
+  Vertex child = n;
+
+  while (child != root)
+  {
+    Vertex parent = ::boost::source(*::boost::in_edges(child, tree).first, tree);
+    ::boost::remove_edge(parent, child, tree);
+    ::boost::add_edge(child, parent, tree);
+    child = parent;
+  }
+
+  root = this->addVertex(tree, ::std::make_shared<::rl::math::Vector>(q));
+  this->addEdge(root, n, tree);
+  this->updateCosts(tree, n);
+
+  return true;
+}
+
+bool
+YourPlanner::replan()
+{
+  EventTracer::Span span("planner", "replan");
+
+  // The scene is static, so every vertex and edge of the previous trees is still free
+  bool connected = NULL != this->end[0] && NULL != this->end[1];
+
+  for (::std::size_t i = 0; i < 2; ++i)
+  {
+    const ::rl::math::Vector& q = 0 == i ? *this->start : *this->goal;
+    ::std::size_t vertices = ::boost::num_vertices(this->tree[i]);
+
+    if (this->graft(this->tree[i], this->begin[i], q))
+    {
+      this->reusedVertices += vertices;
+    }
+    else
+    {
+      // Nothing near q is reachable, grow this tree from scratch
+      this->tree[i].clear();
+      this->boundaryNodes[i].clear();
+      this->begin[i] = this->addVertex(this->tree[i], ::std::make_shared<::rl::math::Vector>(q));
+      connected = false;
+    }
+  }
+
+  if (!connected)
+  {
+    this->end[0] = NULL;
+    this->end[1] = NULL;
+    this->connections.clear();
+  }
+
+  return connected;
+}
+
+// Every combination is available to YourPlannerT
+template bool YourPlanner::solveWith< UniformSampling, ModelMetric, NoDomain >();
+template bool YourPlanner::solveWith< UniformSampling, ModelMetric, DynamicDomain >();
+template bool YourPlanner::solveWith< UniformSampling, WeightedMetric, NoDomain >();
+template bool YourPlanner::solveWith< UniformSampling, WeightedMetric, DynamicDomain >();
+template bool YourPlanner::solveWith< GoalBiasedSampling, ModelMetric, NoDomain >();
+template bool YourPlanner::solveWith< GoalBiasedSampling, ModelMetric, DynamicDomain >();
+template bool YourPlanner::solveWith< GoalBiasedSampling, WeightedMetric, NoDomain >();
+template bool YourPlanner::solveWith< GoalBiasedSampling, WeightedMetric, DynamicDomain >();
@@ -5,7 +5,22 @@
 #define M_PI           3.14159265358979323846
 #endif
 
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <rl/plan/SimpleModel.h>
+
+#include "BatchKinematics.h"
+#include "CollisionIndex.h"
+#include "ContinuousVerifier.h"
+#include "OccupancyGrid.h"
 #include "RrtConConBase.h"
+#include "WorkerPool.h"
+#include "YourPlannerPolicies.h"
 #include "YourSampler.h"
 
 using namespace ::rl::plan;
@@ -13,6 +28,9 @@ using namespace ::rl::plan;
 /**
 *	The implementation of your planner.
 *	modify any of the existing methods to improve planning performance.
+*
+*	The extension toggles are read once per solve(), which then runs the
+*	planning loop compiled for that combination of policies (YourPlannerPolicies.h).
 */
 
 
@@ -28,27 +46,126 @@ public:
 
   virtual ::std::string getName() const;
 
+  /** Clears the trees and the known-colliding index */
+  void reset();
+
   bool solve();
 
+  /** Seeds the planner-owned engine used by goal bias and dynamic-domain sampling */
+  void seed(const ::std::mt19937::result_type& value);
+
+  /**
+  *	Creates the planner for a combination of policy names joined by '+',
+  *	e.g. "goalbias+weighted+dynamicdomain", omitted policies are off.
+  *	Returns an empty pointer for unknown names.
+  */
+  static ::std::shared_ptr< YourPlanner > create(const ::std::string& name, DistributionType distType = DistributionType::NORMAL);
+
   Tree* currentTree;
 
   // Extension toggle flags (set before calling solve())
   bool useDynamicDomain;   // Extension 1: dynamic-domain rejection sampling
   bool useWeightedMetric;  // Extension 2: weighted joint-space distance metric
   bool useGoalBias;        // Extension 3: bidirectional goal-biased sampling
+  bool useAnytime;         // Extension 4: RRT*-Connect refinement after the first solution
+  bool useInformedSampling; // Extension 4: only sample where the best path can still improve
+  bool useWarmStart;       // Extension 5: keep the trees and graft a moved start/goal onto them
+  bool useCollisionIndex;  // Extension 7: reject samples and first connect steps next to known collisions
 
   // Dynamic-domain state (Extension 1)
-  bool hasBoundaryNodes;
-  ::rl::math::Vector bbMin;
-  ::rl::math::Vector bbMax;
-  ::rl::math::Real boundaryRadius;
+  ::std::vector< ::std::vector< Vertex > > boundaryNodes;  // boundary nodes per tree
+  ::rl::math::Real boundaryRatio;      // share of samples drawn from the boundary balls
+  ::rl::math::Real boundaryRadius;     // initial radius of a new boundary node
+  ::rl::math::Real minBoundaryRadius;  // a boundary radius never shrinks below this
+  ::rl::math::Real boundaryGrowth;     // radius factor after a successful extension from a boundary node
+  ::rl::math::Real boundaryShrink;     // radius factor after a failed extension from a boundary node
 
-  void expandBoundingBox(const ::rl::math::Vector& q);
+  struct DomainStatistics
+  {
+    ::std::size_t samples;   // samples drawn in the rejection loop
+    ::std::size_t rejected;  // samples outside the nearest node's radius
+    ::std::size_t grown;     // radius increases
+    ::std::size_t shrunk;    // radius decreases
+    ::std::size_t ballSamples;   // draws inside a boundary ball
+    ::std::size_t ballAccepted;  // draws kept, ballAccepted / ballSamples is the union's acceptance rate
+  };
+
+  const DomainStatistics& getDomainStatistics() const { return domainStatistics; }
+
+  /** Uniform sample from the union of the boundary balls of tree, within the joint limits */
+  void sampleBoundary(const Tree& tree, const ::std::vector< Vertex >& boundary, ::rl::math::Vector& chosen);
   void markBoundary(Tree& tree, const Vertex& v);
+  void growBoundary(Tree& tree, const Vertex& v);
 
-  // Weighted metric state (Extension 2)
+  // Weighted metric state (Extension 2), linear from base to end-effector unless set before solve()
   ::rl::math::Vector weights;
 
+  // Anytime state (Extension 4)
+  ::std::chrono::steady_clock::duration anytimeDuration;  // refinement budget after the first solution
+  ::std::size_t anytimeIterations;  // refinement iteration budget, 0 = unlimited
+  ::rl::math::Real rewireRadius;    // radius for choosing parents and rewiring
+
+  /** Best path cost over time: (ms since solve() started, cost) */
+  ::std::vector< ::std::pair< ::rl::math::Real, ::rl::math::Real > > costHistory;
+
+  /** Cost of the best path found so far, infinity before the first solution */
+  ::rl::math::Real getBestCost() const { return bestCost; }
+
+  /** Copy of the best path found so far, safe to call while solve() is running */
+  ::rl::plan::VectorList getBestPath();
+
+  // Warm start state (Extension 5)
+  ::std::size_t graftCandidates;  // nearest vertices tried when grafting a moved start/goal
+
+  /** Vertices of the previous trees that the last solve() started from, 0 on a cold start */
+  ::std::size_t getReusedVertices() const { return reusedVertices; }
+
+  // k-nearest connect state (Extension 6)
+  ::std::size_t connectCandidates;  // nearest vertices tried when connecting the other tree, 1 = nearest only
+
+  /** Collision models for checking further candidates in parallel, connectModels[0] must be model */
+  ::std::vector< ::rl::plan::SimpleModel* > connectModels;
+
+  struct ConnectStatistics
+  {
+    ::std::size_t attempts;      // connects of the other tree
+    ::std::size_t nearest;       // reached from the nearest vertex
+    ::std::size_t others;        // reached from a further candidate
+    ::std::size_t extraQueries;  // collision queries spent on further candidates
+  };
+
+  const ConnectStatistics& getConnectStatistics() const { return connectStatistics; }
+
+  // Known-colliding index (Extension 7), kept across warm starts
+  CollisionIndex collisionIndex;
+
+  struct IndexStatistics
+  {
+    ::std::size_t rejectedSamples;  // samples drawn again because they were next to a known collision
+    ::std::size_t avoidedQueries;   // first connect steps rejected without a collision query
+    ::std::size_t occupiedSamples;  // samples drawn again because their cell is known to collide
+  };
+
+  const IndexStatistics& getIndexStatistics() const { return indexStatistics; }
+
+  /** Joint-space occupancy learned from earlier queries and runs (Extension 8), NULL = off */
+  OccupancyGrid* occupancy;
+
+  /** Frames of the connect steps a block at a time, falls back to the model's kinematics until calibrated */
+  BatchKinematics batch;
+
+  /** Checks connect segments by conservative advancement instead of delta steps (Extension 9), NULL = off */
+  const ContinuousVerifier* continuous;
+
+  struct EdgeStatistics
+  {
+    ::std::size_t edges;     // connects checked as one segment
+    ::std::size_t queries;   // distance evaluations they took
+    ::std::size_t contacts;  // connects stopped short by a contact
+  };
+
+  const EdgeStatistics& getEdgeStatistics() const { return edgeStatistics; }
+
   DistributionType distributionType;
 
 protected:
@@ -56,9 +173,127 @@ protected:
   void choose(::rl::math::Vector& chosen);
   RrtConConBase::Vertex connect(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen);
   Neighbor nearest(const Tree& tree, const ::rl::math::Vector& chosen) override;
-  ::rl::math::Real weightedDistance(const ::rl::math::Vector& a, const ::rl::math::Vector& b) const;
+
+  /** The planning loop for one combination of policies */
+  template< class Sampling, class Metric, class Domain >
+  bool solveWith();
+
+  template< class Sampling, class Domain >
+  void chooseWith(::rl::math::Vector& chosen);
+
+  template< class Metric >
+  Neighbor nearestWith(const Tree& tree, const ::rl::math::Vector& chosen);
+
+  template< class Domain >
+  Vertex connectWith(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen);
+
+  /** connectWith() with the whole segment checked by continuous, stops delta short of the first contact */
+  template< class Domain >
+  Vertex connectContinuousWith(Tree& tree, const Neighbor& nearest, const ::rl::math::Vector& chosen);
+
+  /** Connects tree to target from its nearest vertex, then from the further connectCandidates */
+  template< class Metric, class Domain >
+  Vertex connectTreeWith(Tree& tree, const ::rl::math::Vector& target);
+
+  /** The k nearest vertices of tree, nearest first */
+  template< class Metric >
+  void kNearestWith(const Tree& tree, const ::rl::math::Vector& chosen, const ::std::size_t& k, ::std::vector< Neighbor >& neighbors);
+
+  /** Rank of the first candidate with a free segment to target, candidates.size() if none */
+  ::std::size_t firstFree(const Tree& tree, const ::std::vector< Neighbor >& candidates, const ::rl::math::Vector& target);
+
+  /** Threads of firstFree on connectModels[1..], kept between connects */
+  WorkerPool connectPool;
+
+  /** Draws a sample from the planner's own strategies (goal bias, dynamic domain, sampler) */
+  template< class Sampling, class Domain >
+  void sampleWith(::rl::math::Vector& chosen);
+
+  /** True if the last chosen sample came from the sampler, used to credit its statistics */
+  bool sampledFromSampler;
+
+  /** choose() restricted to samples that can still shorten the best path */
+  template< class Sampling, class Domain >
+  void chooseInformedWith(::rl::math::Vector& chosen);
+
+  /** RRT*: picks the cheapest collision-free parent for v and reroutes its neighbours through v */
+  void rewire(Tree& tree, const Vertex& v);
+
+  /** Recomputes the cost of every vertex below v */
+  void updateCosts(Tree& tree, const Vertex& v);
+
+  /** Checks the straight segment a-b at resolution delta or continuously */
+  bool isFree(const ::rl::math::Vector& a, const ::rl::math::Vector& b);
+
+  /** Checks a-b on model, adds the collision queries spent to queries */
+  bool isFree(::rl::plan::SimpleModel* model, const ::rl::math::Vector& a, const ::rl::math::Vector& b, ::std::size_t& queries) const;
+
+  /** Selects the cheapest tree connection as end[], records it if it improved */
+  void updateBest();
+
+  /** Makes q the new root of tree, hanging the old tree below the nearest vertex with a free segment to q */
+  bool graft(Tree& tree, Vertex& root, const ::rl::math::Vector& q);
+
+  /** Grafts start and goal onto the previous trees, true if the previous connection still holds */
+  bool replan();
+
+  ::std::size_t reusedVertices;
+
+  DomainStatistics domainStatistics;
+
+  ConnectStatistics connectStatistics;
+
+  IndexStatistics indexStatistics;
+
+  EdgeStatistics edgeStatistics;
+
+  /** Vertex pairs (tree 0, tree 1) at which the trees were connected */
+  ::std::vector< ::std::pair< Vertex, Vertex > > connections;
+
+  ::rl::math::Real bestCost;
+
+  ::rl::plan::VectorList bestPath;
+
+  ::std::mutex bestMutex;
+
+  ::std::normal_distribution< ::rl::math::Real > normalDistribution;
+
+  ::std::uniform_real_distribution< ::rl::math::Real > randDistribution;
+
+  ::std::mt19937 randEngine;
 private:
 
 };
 
+/**
+*	YourPlanner with its extensions fixed at compile time.
+*	The toggles reflect the policies and are ignored by solve().
+*/
+template< class Sampling, class Metric, class Domain >
+class YourPlannerT : public YourPlanner
+{
+public:
+  YourPlannerT(DistributionType distType = DistributionType::NORMAL) :
+    YourPlanner(distType)
+  {
+    this->useGoalBias = Sampling::goalBias;
+    this->useWeightedMetric = Metric::weighted;
+    this->useDynamicDomain = Domain::enabled;
+  }
+
+  virtual ~YourPlannerT()
+  {
+  }
+
+  virtual ::std::string getName() const
+  {
+    return ::std::string("Your Planner ") + Sampling::name() + "+" + Metric::name() + "+" + Domain::name();
+  }
+
+  bool solve()
+  {
+    return this->template solveWith< Sampling, Metric, Domain >();
+  }
+};
+
 #endif // _YOUR_PLANNER_H_
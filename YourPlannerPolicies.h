@@ -0,0 +1,81 @@
+#ifndef _YOUR_PLANNER_POLICIES_H_
+#define _YOUR_PLANNER_POLICIES_H_
+
+#include <rl/plan/Model.h>
+
+/**
+*	Policy types for YourPlanner's extensions.
+*	solveWith() is instantiated once per combination, so the hot loop has no
+*	runtime switches and the metric kernel is inlined into nearest.
+*/
+
+/** Samples come from the sampler and the dynamic domain only */
+struct UniformSampling
+{
+  static const bool goalBias = false;
+
+  static const char* name() { return "uniform"; }
+};
+
+/** Extension 3: every 20th sample is the root of the other tree */
+struct GoalBiasedSampling
+{
+  static const bool goalBias = true;
+
+  static const char* name() { return "goalbias"; }
+};
+
+/** The model's own metric, compared in its transformed (squared) form */
+struct ModelMetric
+{
+  static const bool weighted = false;
+
+  static const char* name() { return "model"; }
+
+  static ::rl::math::Real compare(const ::rl::plan::Model& model, const ::rl::math::Vector& weights, const ::rl::math::Vector& a, const ::rl::math::Vector& b)
+  {
+    return model.transformedDistance(a, b);
+  }
+
+  static ::rl::math::Real distance(const ::rl::plan::Model& model, const ::rl::math::Vector& a, const ::rl::math::Vector& b, const ::rl::math::Real& compared)
+  {
+    return model.inverseOfTransformedDistance(compared);
+  }
+};
+
+/** Extension 2: squared joint distances weighted from base to end-effector */
+struct WeightedMetric
+{
+  static const bool weighted = true;
+
+  static const char* name() { return "weighted"; }
+
+  static ::rl::math::Real compare(const ::rl::plan::Model& model, const ::rl::math::Vector& weights, const ::rl::math::Vector& a, const ::rl::math::Vector& b)
+  {
+    return (weights.array() * (a - b).array().square()).sum();
+  }
+
+  // Only the winner pays for the model distance used by connect()
+  static ::rl::math::Real distance(const ::rl::plan::Model& model, const ::rl::math::Vector& a, const ::rl::math::Vector& b, const ::rl::math::Real& compared)
+  {
+    return model.distance(a, b);
+  }
+};
+
+/** Every vertex may be extended towards every sample */
+struct NoDomain
+{
+  static const bool enabled = false;
+
+  static const char* name() { return "nodomain"; }
+};
+
+/** Extension 1: boundary nodes only accept samples within their radius */
+struct DynamicDomain
+{
+  static const bool enabled = true;
+
+  static const char* name() { return "dynamicdomain"; }
+};
+
+#endif // _YOUR_PLANNER_POLICIES_H_
@@ -1,18 +1,78 @@
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <rl/plan/SimpleModel.h>
+#include "SamplePool.h"
 #include "YourSampler.h"
 
+namespace
+{
+    ::rl::math::Real
+    normalCdf(const ::rl::math::Real& x)
+    {
+        return 0.5 * ::std::erfc(-x / ::std::sqrt(2.0));
+    }
+
+    /** Inverse of the standard normal CDF: Acklam's approximation refined by one Halley step */
+    ::rl::math::Real
+    normalQuantile(const ::rl::math::Real& p)
+    {
+        static const ::rl::math::Real a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+        static const ::rl::math::Real b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+        static const ::rl::math::Real c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+        static const ::rl::math::Real d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00, 3.754408661907416e+00};
+        static const ::rl::math::Real low = 0.02425;
+
+        ::rl::math::Real x;
+
+        if (p < low)
+        {
+            ::rl::math::Real q = ::std::sqrt(-2 * ::std::log(p));
+            x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+        }
+        else if (p <= 1 - low)
+        {
+            ::rl::math::Real q = p - 0.5;
+            ::rl::math::Real r = q * q;
+            x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+        }
+        else
+        {
+            ::rl::math::Real q = ::std::sqrt(-2 * ::std::log(1 - p));
+            x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+        }
+
+        ::rl::math::Real e = normalCdf(x) - p;
+        ::rl::math::Real u = e * ::std::sqrt(2 * M_PI) * ::std::exp(x * x / 2);
+
+        return x - u / (1 + x * u / 2);
+    }
+}
+
 namespace rl
 {
     namespace plan
     {
         YourSampler::YourSampler(DistributionType distType) :
             Sampler(),
+            uniformRatio(0.1),
+            narrowSigma(0.05),
+            narrowAttempts(100),
+            batchSize(256),
+            pool(NULL),
             distributionType(distType),
+            lastType(distType),
+            lastPooled(false),
             randDistribution(0, 1),
             normalDistribution(0.5, 0.15),
-            randEngine(::std::random_device()())
+            gaussDistribution(0, 1),
+            randEngine(::std::random_device()()),
+            mixture(),
+            mixtureBounds(),
+            batch(),
+            batchIndex(0)
         {
+            this->resetStatistics();
         }
 
         YourSampler::~YourSampler()
@@ -27,38 +87,363 @@ namespace rl
             // BUT PLEASE MAKE SURE YOU CONFORM TO JOINT LIMITS,
             // AS SPECIFIED BY THE ROBOT MODEL!
 
+            ::rl::math::Vector pooled;
+
+            // The pool overrides the mode until it is exhausted, its samples are counted apart
+            if (NULL != this->pool && this->pool->draw(pooled))
+            {
+                this->lastPooled = true;
+                ++this->poolStatistics.samples;
+                return pooled;
+            }
+
+            this->lastPooled = false;
+            this->lastType = this->distributionType;
+
+            switch (this->distributionType)
+            {
+            case DistributionType::GAUSSIAN:
+            case DistributionType::BRIDGE:
+            case DistributionType::OBSTACLE:
+                if (this->rand() < this->uniformRatio)
+                {
+                    this->lastType = DistributionType::UNIFORM;
+                }
+                break;
+            default:
+                break;
+            }
+
+            ++this->statistics[static_cast< ::std::size_t >(this->lastType)].samples;
+
+            switch (this->lastType)
+            {
+            case DistributionType::NORMAL:
+                return this->generateNormal();
+            case DistributionType::CLAMPED_NORMAL:
+                return this->generateClampedNormal();
+            case DistributionType::GAUSSIAN:
+                return this->generateGaussian();
+            case DistributionType::BRIDGE:
+                return this->generateBridge();
+            case DistributionType::OBSTACLE:
+                return this->generateObstacle();
+            default:
+                return this->generateUniform();
+            }
+        }
+
+        ::rl::math::Vector
+        YourSampler::generateUniform()
+        {
             ::rl::math::Vector sampleq(this->model->getDof());
             ::rl::math::Vector maximum(this->model->getMaximum());
             ::rl::math::Vector minimum(this->model->getMinimum());
 
-            if (distributionType == DistributionType::UNIFORM)
+            for (::std::size_t i = 0; i < this->model->getDof(); ++i)
             {
-                // Uniform distribution sampling
-                for (::std::size_t i = 0; i < this->model->getDof(); ++i)
+                sampleq(i) = minimum(i) + this->rand() * (maximum(i) - minimum(i));
+            }
+
+            return sampleq;
+        }
+
+        ::rl::math::Vector
+        YourSampler::generateNormal()
+        {
+            if (this->batchIndex >= static_cast< ::std::size_t >(this->batch.cols()))
+            {
+                this->fillBatch();
+            }
+
+            return this->batch.col(this->batchIndex++);
+        }
+
+        ::rl::math::Vector
+        YourSampler::generateClampedNormal()
+        {
+            ::rl::math::Vector sampleq(this->model->getDof());
+            ::rl::math::Vector maximum(this->model->getMaximum());
+            ::rl::math::Vector minimum(this->model->getMinimum());
+
+            // Normal distribution sampling (centered at midpoint)
+            for (::std::size_t i = 0; i < this->model->getDof(); ++i)
+            {
+                ::rl::math::Real sample = this->normalDistribution(this->randEngine);
+                // Clamp to [0, 1] and scale to joint limits
+                sample = std::max(0.0, std::min(1.0, sample));
+                sampleq(i) = minimum(i) + sample * (maximum(i) - minimum(i));
+            }
+
+            return sampleq;
+        }
+
+        void
+        YourSampler::fillBatch()
+        {
+            ::std::size_t dof = this->model->getDof();
+            ::rl::math::Vector maximum(this->model->getMaximum());
+            ::rl::math::Vector minimum(this->model->getMinimum());
+            ::rl::math::Vector range = maximum - minimum;
+
+            if (this->mixture.empty() || static_cast< ::std::size_t >(this->mixture.front().mean.size()) != dof)
+            {
+                NormalComponent component;
+                component.weight = 1;
+                component.mean = ::rl::math::Vector::Constant(dof, 0.5);
+                component.sigma = ::rl::math::Vector::Constant(dof, 0.15);
+                this->setMixture(::std::vector< NormalComponent >(1, component));
+            }
+
+            // The CDF at both joint limits only depends on the mixture, compute it once
+            if (this->mixtureBounds.size() != this->mixture.size())
+            {
+                this->mixtureBounds.clear();
+
+                for (::std::size_t k = 0; k < this->mixture.size(); ++k)
+                {
+                    const NormalComponent& component = this->mixture[k];
+                    ::rl::math::Vector lower(dof);
+                    ::rl::math::Vector upper(dof);
+
+                    for (::std::size_t i = 0; i < dof; ++i)
+                    {
+                        lower(i) = normalCdf((0 - component.mean(i)) / component.sigma(i));
+                        upper(i) = normalCdf((1 - component.mean(i)) / component.sigma(i));
+                    }
+
+                    this->mixtureBounds.push_back(::std::make_pair(lower, upper));
+                }
+            }
+
+            ::rl::math::Real totalWeight = 0;
+
+            for (::std::size_t k = 0; k < this->mixture.size(); ++k)
+            {
+                totalWeight += this->mixture[k].weight;
+            }
+
+            this->batch.resize(dof, this->batchSize);
+
+            for (::std::size_t j = 0; j < this->batchSize; ++j)
+            {
+                // Pick a component proportional to its weight
+                ::rl::math::Real pick = this->rand() * totalWeight;
+                ::std::size_t k = 0;
+
+                while (k + 1 < this->mixture.size() && pick >= this->mixture[k].weight)
+                {
+                    pick -= this->mixture[k].weight;
+                    ++k;
+                }
+
+                const NormalComponent& component = this->mixture[k];
+
+                for (::std::size_t i = 0; i < dof; ++i)
                 {
-                    sampleq(i) = minimum(i) + this->rand() * (maximum(i) - minimum(i));
+                    ::rl::math::Real sample = this->truncatedNormal(
+                        component.mean(i),
+                        component.sigma(i),
+                        this->mixtureBounds[k].first(i),
+                        this->mixtureBounds[k].second(i)
+                    );
+
+                    this->batch(i, j) = minimum(i) + sample * range(i);
                 }
             }
-            else
+
+            this->batchIndex = 0;
+        }
+
+        ::rl::math::Real
+        YourSampler::truncatedNormal(const ::rl::math::Real& mean, const ::rl::math::Real& sigma, const ::rl::math::Real& lower, const ::rl::math::Real& upper)
+        {
+            // Plain rejection is cheapest while most of the mass lies inside
+            // the limits, the inverse CDF handles components far in the tails.
+            if (upper - lower > 0.25)
             {
-                // Normal distribution sampling (centered at midpoint)
+                ::rl::math::Real sample;
+
+                do
+                {
+                    sample = mean + sigma * this->gaussDistribution(this->randEngine);
+                }
+                while (sample < 0 || sample > 1);
+
+                return sample;
+            }
+
+            ::rl::math::Real p = lower + this->rand() * (upper - lower);
+            p = ::std::max(p, ::std::numeric_limits< ::rl::math::Real >::min());
+            p = ::std::min(p, 1 - ::std::numeric_limits< ::rl::math::Real >::epsilon());
+
+            ::rl::math::Real sample = mean + sigma * normalQuantile(p);
+
+            // Round-off in the far tails may leave the interval by an ulp
+            return ::std::max< ::rl::math::Real >(0, ::std::min< ::rl::math::Real >(1, sample));
+        }
+
+        ::rl::math::Vector
+        YourSampler::generateGaussian()
+        {
+            // Boor et al.: of a pair at Gaussian distance, keep the free
+            // configuration if exactly one of the two is colliding.
+            for (::std::size_t k = 0; k < this->narrowAttempts; ++k)
+            {
+                ::rl::math::Vector q1 = this->generateUniform();
+                ::rl::math::Vector q2 = this->perturb(q1);
+
+                bool colliding1 = this->isColliding(q1);
+                bool colliding2 = this->isColliding(q2);
+
+                if (colliding1 && !colliding2)
+                {
+                    return q2;
+                }
+                else if (!colliding1 && colliding2)
+                {
+                    return q1;
+                }
+            }
+
+            return this->generateUniform();
+        }
+
+        ::rl::math::Vector
+        YourSampler::generateBridge()
+        {
+            // Hsu et al.: a free midpoint between two colliding configurations
+            // at Gaussian distance lies inside a narrow passage.
+            ::rl::math::Vector qm(this->model->getDof());
+
+            for (::std::size_t k = 0; k < this->narrowAttempts; ++k)
+            {
+                ::rl::math::Vector q1 = this->generateUniform();
+
+                if (!this->isColliding(q1))
+                {
+                    continue;
+                }
+
+                ::rl::math::Vector q2 = this->perturb(q1);
+
+                if (!this->isColliding(q2))
+                {
+                    continue;
+                }
+
+                this->model->interpolate(q1, q2, 0.5, qm);
+
+                if (!this->isColliding(qm))
+                {
+                    return qm;
+                }
+            }
+
+            return this->generateUniform();
+        }
+
+        ::rl::math::Vector
+        YourSampler::generateObstacle()
+        {
+            // Obstacle-based: from a colliding configuration, step along a random
+            // direction until the robot is free and return that boundary sample.
+            ::rl::math::Vector maximum(this->model->getMaximum());
+            ::rl::math::Vector minimum(this->model->getMinimum());
+            ::rl::math::Vector direction(this->model->getDof());
+
+            for (::std::size_t k = 0; k < this->narrowAttempts; ++k)
+            {
+                ::rl::math::Vector q = this->generateUniform();
+
+                if (!this->isColliding(q))
+                {
+                    continue;
+                }
+
                 for (::std::size_t i = 0; i < this->model->getDof(); ++i)
                 {
-                    ::rl::math::Real sample = this->normalDistribution(this->randEngine);
-                    // Clamp to [0, 1] and scale to joint limits
-                    sample = std::max(0.0, std::min(1.0, sample));
-                    sampleq(i) = minimum(i) + sample * (maximum(i) - minimum(i));
+                    direction(i) = this->gaussDistribution(this->randEngine) * this->narrowSigma * (maximum(i) - minimum(i));
+                }
+
+                for (::std::size_t step = 0; step < this->narrowAttempts; ++step)
+                {
+                    q += direction;
+
+                    if ((q.array() < minimum.array()).any() || (q.array() > maximum.array()).any())
+                    {
+                        break;
+                    }
+
+                    if (!this->isColliding(q))
+                    {
+                        return q;
+                    }
                 }
             }
 
-            // It is a good practice to generate samples in the
-            // the allowed configuration space as done above.
-            // Alternatively, to make sure generated joint 
-            // configuration values are clipped to the robot model's 
-            // joint limits, you may use the clip() function like this: 
-            // this->model->clip(sampleq);
+            return this->generateUniform();
+        }
+
+        bool
+        YourSampler::isColliding(const ::rl::math::Vector& q)
+        {
+            ++this->statistics[static_cast< ::std::size_t >(this->lastType)].collisionChecks;
 
-            return sampleq;
+            this->model->setPosition(q);
+            this->model->updateFrames();
+
+            return this->model->isColliding();
+        }
+
+        ::rl::math::Vector
+        YourSampler::perturb(const ::rl::math::Vector& q)
+        {
+            ::rl::math::Vector maximum(this->model->getMaximum());
+            ::rl::math::Vector minimum(this->model->getMinimum());
+            ::rl::math::Vector perturbed(q);
+
+            for (::std::size_t i = 0; i < this->model->getDof(); ++i)
+            {
+                perturbed(i) += this->gaussDistribution(this->randEngine) * this->narrowSigma * (maximum(i) - minimum(i));
+            }
+
+            this->model->clip(perturbed);
+
+            return perturbed;
+        }
+
+        void
+        YourSampler::addVertices(const ::std::size_t& count)
+        {
+            if (this->lastPooled)
+            {
+                this->poolStatistics.vertices += count;
+                return;
+            }
+
+            this->statistics[static_cast< ::std::size_t >(this->lastType)].vertices += count;
+        }
+
+        const YourSampler::Statistics&
+        YourSampler::getStatistics(DistributionType type) const
+        {
+            return this->statistics[static_cast< ::std::size_t >(type)];
+        }
+
+        void
+        YourSampler::resetStatistics()
+        {
+            for (::std::size_t i = 0; i < this->statistics.size(); ++i)
+            {
+                this->statistics[i].samples = 0;
+                this->statistics[i].collisionChecks = 0;
+                this->statistics[i].vertices = 0;
+            }
+
+            this->poolStatistics.samples = 0;
+            this->poolStatistics.collisionChecks = 0;
+            this->poolStatistics.vertices = 0;
         }
 
         ::std::uniform_real_distribution< ::rl::math::Real>::result_type
@@ -71,7 +456,25 @@ namespace rl
         YourSampler::seed(const ::std::mt19937::result_type& value)
         {
             this->randEngine.seed(value);
+            this->gaussDistribution.reset();
+            this->normalDistribution.reset();
+            this->batchIndex = this->batch.cols();
+        }
+
+        void
+        YourSampler::setDistributionType(DistributionType distType)
+        {
+            this->distributionType = distType;
+            this->lastType = distType;
+            this->batchIndex = this->batch.cols();
+        }
+
+        void
+        YourSampler::setMixture(const ::std::vector< NormalComponent >& mixture)
+        {
+            this->mixture = mixture;
+            this->mixtureBounds.clear();
+            this->batchIndex = this->batch.cols();
         }
     }
 }
-
@@ -3,7 +3,11 @@
 
 
 #include <rl/plan/Sampler.h>
+#include <array>
 #include <random>
+#include <vector>
+
+class SamplePool;
 
 namespace rl
 {
@@ -12,15 +16,49 @@ namespace rl
         enum class DistributionType
         {
             UNIFORM,
-            NORMAL
+            NORMAL,     // exact truncated normal mixture within the joint limits
+            GAUSSIAN,   // pairs at Gaussian distance, keep the free one of a free/colliding pair
+            BRIDGE,     // midpoint of two colliding configurations, if free
+            OBSTACLE,   // walk out of an obstacle along a random direction
+            CLAMPED_NORMAL  // N(0.5, 0.15) clamped to the joint limits, kept for comparison
         };
 
         /**
          * Random sampling strategy with configurable distribution.
+         *
+         * The GAUSSIAN, BRIDGE and OBSTACLE modes spend a few collision checks
+         * per sample to concentrate samples near C-space obstacle boundaries and
+         * inside narrow passages. With probability uniformRatio they return a
+         * plain uniform sample instead.
+         *
+         * NORMAL draws from a mixture of per-joint truncated normals in joint
+         * range coordinates [0, 1], so no probability mass piles up on the
+         * joint limits. Samples are generated in batches of batchSize.
+         *
+         * While a precomputed pool is attached, generate() returns its
+         * collision-free configurations first, whatever the distribution type,
+         * and only then samples live in that mode. Pooled samples are counted
+         * in getPoolStatistics(), not under a mode.
          */
         class YourSampler : public Sampler
         {
         public:
+            /** Per-mode cost and benefit of the generated samples */
+            struct Statistics
+            {
+                ::std::size_t samples;
+                ::std::size_t collisionChecks;
+                ::std::size_t vertices;
+            };
+
+            /** One mixture component; mean and sigma per joint, relative to the joint range */
+            struct NormalComponent
+            {
+                ::rl::math::Real weight;
+                ::rl::math::Vector mean;
+                ::rl::math::Vector sigma;
+            };
+
             YourSampler(DistributionType distType = DistributionType::NORMAL);
 
             virtual ~YourSampler();
@@ -29,16 +67,91 @@ namespace rl
 
             virtual void seed(const ::std::mt19937::result_type& value);
 
+            void setDistributionType(DistributionType distType);
+
+            DistributionType getDistributionType() const { return distributionType; }
+
+            /** Replaces the NORMAL mixture, an empty mixture means N(0.5, 0.15) on every joint */
+            void setMixture(const ::std::vector< NormalComponent >& mixture);
+
+            /** Credits vertices gained by the planner to the mode of the last sample */
+            void addVertices(const ::std::size_t& count = 1);
+
+            const Statistics& getStatistics(DistributionType type) const;
+
+            /** Samples taken from the pool and the vertices they gained */
+            const Statistics& getPoolStatistics() const { return poolStatistics; }
+
+            void resetStatistics();
+
+            /** Probability of a plain uniform sample in the narrow-passage modes */
+            ::rl::math::Real uniformRatio;
+
+            /** Standard deviation of the pair distance, relative to the joint range */
+            ::rl::math::Real narrowSigma;
+
+            /** Attempts per narrow-passage sample before falling back to uniform */
+            ::std::size_t narrowAttempts;
+
+            /** Number of NORMAL samples generated per batch */
+            ::std::size_t batchSize;
+
+            /** Optional pool of precomputed collision-free configurations (NULL = off) */
+            SamplePool* pool;
+
         protected:
             ::std::uniform_real_distribution< ::rl::math::Real>::result_type rand();
 
+            ::rl::math::Vector generateUniform();
+
+            ::rl::math::Vector generateNormal();
+
+            ::rl::math::Vector generateClampedNormal();
+
+            /** Fills the sample batch from the truncated normal mixture */
+            void fillBatch();
+
+            /** Draws from N(mean, sigma) truncated to [0, 1], lower and upper are the CDF bounds */
+            ::rl::math::Real truncatedNormal(const ::rl::math::Real& mean, const ::rl::math::Real& sigma, const ::rl::math::Real& lower, const ::rl::math::Real& upper);
+
+            ::rl::math::Vector generateGaussian();
+
+            ::rl::math::Vector generateBridge();
+
+            ::rl::math::Vector generateObstacle();
+
+            /** Collision check charged to the statistics of the current mode */
+            bool isColliding(const ::rl::math::Vector& q);
+
+            /** q plus a Gaussian offset of narrowSigma per joint, clipped to the joint limits */
+            ::rl::math::Vector perturb(const ::rl::math::Vector& q);
+
             DistributionType distributionType;
-            
+
+            DistributionType lastType;
+
+            /** The last sample came from the pool */
+            bool lastPooled;
+
             ::std::uniform_real_distribution< ::rl::math::Real> randDistribution;
             ::std::normal_distribution< ::rl::math::Real> normalDistribution;
+            ::std::normal_distribution< ::rl::math::Real> gaussDistribution;
 
             ::std::mt19937 randEngine;
 
+            ::std::array< Statistics, 6 > statistics;
+
+            Statistics poolStatistics;
+
+            ::std::vector< NormalComponent > mixture;
+
+            /** Normal CDF at the joint limits for every mixture component */
+            ::std::vector< ::std::pair< ::rl::math::Vector, ::rl::math::Vector > > mixtureBounds;
+
+            ::rl::math::Matrix batch;
+
+            ::std::size_t batchIndex;
+
         private:
 
         };
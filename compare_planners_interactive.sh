@@ -5,9 +5,11 @@
 
 SCRIPT_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
 BUILD_DIR="$SCRIPT_DIR/build"
-HEADER_FILE="$SCRIPT_DIR/TutorialPlanSystem.h"
 BENCHMARK_FILE="$BUILD_DIR/benchmark.csv"
 
+# Planner passed to tutorialPlan as --planner: "base" runs RrtConConBase, "rrt" YourPlanner
+PLANNER="rrt"
+
 # Colors
 RED='\033[0;31m'
 GREEN='\033[0;32m'
@@ -22,19 +24,19 @@ echo -e "║   Planner Comparison Helper Script        ║"
 echo -e "╚════════════════════════════════════════════╝${NC}"
 echo ""
 
-# Backup the original header file
-echo -e "${YELLOW}Creating backup of TutorialPlanSystem.h...${NC}"
-cp "$HEADER_FILE" "$HEADER_FILE.backup"
-
-# Function to restore original file
-cleanup() {
-    if [ -f "$HEADER_FILE.backup" ]; then
-        echo -e "\n${YELLOW}Restoring original TutorialPlanSystem.h...${NC}"
-        mv "$HEADER_FILE.backup" "$HEADER_FILE"
-        echo -e "${GREEN}Original file restored.${NC}"
+# Function to build tutorialPlan, both planners are compiled in
+build() {
+    echo -e "${YELLOW}Compiling...${NC}"
+    cd "$BUILD_DIR"
+    if make -j4 2>&1 | grep -q "error:"; then
+        echo -e "${RED}Compilation failed! Check for errors.${NC}"
+        make
+        return 1
+    else
+        echo -e "${GREEN}Compilation successful!${NC}"
+        return 0
     fi
 }
-trap cleanup EXIT
 
 # Function to switch planner
 switch_to_planner() {
@@ -42,35 +44,19 @@ switch_to_planner() {
     
     if [ "$planner_type" = "baseline" ]; then
         echo -e "${CYAN}Switching to RrtConConBase (baseline)...${NC}"
-        sed -i.tmp 's|#include "YourPlanner.h"|#include "RrtConConBase.h"|' "$HEADER_FILE"
-        sed -i.tmp 's|YourPlanner planner;|RrtConConBase planner;  //Baseline planner|' "$HEADER_FILE"
+        PLANNER="base"
     else
         echo -e "${CYAN}Switching to YourPlanner...${NC}"
-        sed -i.tmp 's|#include "RrtConConBase.h"|#include "YourPlanner.h"|' "$HEADER_FILE"
-        sed -i.tmp 's|RrtConConBase planner;.*|YourPlanner planner;  //The implementation of your planner|' "$HEADER_FILE"
-    fi
-    rm -f "$HEADER_FILE.tmp"
-    
-    echo -e "${YELLOW}Compiling...${NC}"
-    cd "$BUILD_DIR"
-    if make -j4 2>&1 | grep -q "error:"; then
-        echo -e "${RED}Compilation failed! Check for errors.${NC}"
-        make
-        return 1
-    else
-        echo -e "${GREEN}Compilation successful!${NC}"
-        return 0
+        PLANNER="rrt"
     fi
 }
 
 # Function to display current planner
 show_current_planner() {
-    if grep -q "YourPlanner planner" "$HEADER_FILE"; then
-        echo -e "${GREEN}Current planner: YourPlanner${NC}"
-    elif grep -q "RrtConConBase planner" "$HEADER_FILE"; then
+    if [ "$PLANNER" = "base" ]; then
         echo -e "${GREEN}Current planner: RrtConConBase (baseline)${NC}"
     else
-        echo -e "${YELLOW}Current planner: Unknown${NC}"
+        echo -e "${GREEN}Current planner: YourPlanner${NC}"
     fi
 }
 
@@ -88,7 +74,7 @@ show_results() {
     echo "Date       | Time        | Solved | Planner        | Vertices | Queries | Runtime(ms)"
     echo "-----------|-------------|--------|----------------|----------|---------|------------"
     
-    tail -5 "$BENCHMARK_FILE" | while IFS=',' read -r date time solved planner vertices col_q free_q runtime; do
+    tail -5 "$BENCHMARK_FILE" | while IFS=',' read -r date time solved planner vertices col_q free_q runtime rest; do
         printf "%-10s | %-11s | %-6s | %-14s | %-8s | %-7s | %s\n" \
             "$date" "$time" "$solved" "$planner" "$vertices" "$col_q" "$runtime"
     done
@@ -115,8 +101,8 @@ compare_last_two() {
     local result1=$(tail -2 "$BENCHMARK_FILE" | head -1)
     local result2=$(tail -1 "$BENCHMARK_FILE")
     
-    IFS=',' read -r date1 time1 solved1 planner1 vertices1 col_q1 free_q1 runtime1 <<< "$result1"
-    IFS=',' read -r date2 time2 solved2 planner2 vertices2 col_q2 free_q2 runtime2 <<< "$result2"
+    IFS=',' read -r date1 time1 solved1 planner1 vertices1 col_q1 free_q1 runtime1 rest1 <<< "$result1"
+    IFS=',' read -r date2 time2 solved2 planner2 vertices2 col_q2 free_q2 runtime2 rest2 <<< "$result2"
     
     echo -e "${CYAN}First Result:${NC}"
     echo "  Planner: $planner1"
@@ -175,8 +161,8 @@ while true; do
     show_current_planner
     echo ""
     echo -e "${YELLOW}What would you like to do?${NC}"
-    echo "  1) Switch to RrtConConBase (baseline) and compile"
-    echo "  2) Switch to YourPlanner and compile"
+    echo "  1) Switch to RrtConConBase (baseline)"
+    echo "  2) Switch to YourPlanner"
     echo "  3) Run current planner (opens GUI)"
     echo "  4) Show recent results"
     echo "  5) Compare last two results"
@@ -197,8 +183,9 @@ while true; do
             echo -e "${CYAN}Starting planner...${NC}"
             echo -e "${YELLOW}Please use the GUI to click 'Start Planning' when ready.${NC}"
             echo -e "${YELLOW}Results will be saved automatically to benchmark.csv${NC}"
+            build || continue
             cd "$BUILD_DIR"
-            ./tutorialPlan
+            ./tutorialPlan --planner "$PLANNER"
             echo -e "${GREEN}Program closed.${NC}"
             ;;
         4)
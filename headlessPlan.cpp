@@ -0,0 +1,112 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "EventTracer.h"
+#include "TutorialPlanSystem.h"
+
+//  Plans without any GUI: no QApplication, SoQt or viewer is created, every
+//  run appends its row to benchmark.csv like tutorialPlan does.
+//
+//  usage: headlessPlan [--scene FILE] [--kinematics FILE] [--runs N] [--trace FILE] [OPTIONS]
+//  OPTIONS are those of tutorialPlan, e.g. --start 0,0,90,0,0,0 --goal ... --planner rrt --seed 1,
+//  see TutorialPlanSystem::setOption.
+int
+main(int argc, char** argv)
+{
+  std::string sceneFilename = "../xml/rlsg/unimation-puma560-rbo_wall.xml";
+  std::string kinematicsFilename = "../xml/rlkin/unimation-puma560.xml";
+  std::size_t runs = 1;
+  const char* traceFilename = NULL;
+
+  //  The scene and kinematics are needed to construct the system, the rest is applied to it
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    if (0 == std::strcmp(argv[i], "--scene"))
+    {
+      sceneFilename = argv[i + 1];
+    }
+    else if (0 == std::strcmp(argv[i], "--kinematics"))
+    {
+      kinematicsFilename = argv[i + 1];
+    }
+    else if (0 == std::strcmp(argv[i], "--runs"))
+    {
+      runs = std::strtoul(argv[i + 1], NULL, 10);
+    }
+    else if (0 == std::strcmp(argv[i], "--trace"))
+    {
+      traceFilename = argv[i + 1];
+      EventTracer::start();
+      EventTracer::setThreadName("planner");
+    }
+    else if (0 != std::strncmp(argv[i], "--", 2))
+    {
+      std::cout << "usage: " << argv[0] << " [--scene FILE] [--kinematics FILE] [--runs N] [--trace FILE] [OPTIONS]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (0 == argc % 2)
+  {
+    std::cout << "option " << argv[argc - 1] << " needs a value" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  TutorialPlanSystem system(rl::plan::DistributionType::NORMAL, sceneFilename, kinematicsFilename);
+
+  if (0 == system.getSceneHash())
+  {
+    std::cout << "cannot read scene or kinematics file" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  bool warmStart = false;
+
+  for (int i = 1; i + 1 < argc; i += 2)
+  {
+    if (0 == std::strcmp(argv[i], "--scene") || 0 == std::strcmp(argv[i], "--kinematics") ||
+        0 == std::strcmp(argv[i], "--runs") || 0 == std::strcmp(argv[i], "--trace"))
+    {
+      continue;
+    }
+
+    if (!system.setOption(argv[i] + 2, argv[i + 1]))
+    {
+      return EXIT_FAILURE;
+    }
+
+    if (0 == std::strcmp(argv[i], "--warm-start"))
+    {
+      warmStart = 0 == std::strcmp(argv[i + 1], "on");
+    }
+  }
+
+  std::size_t solved = 0;
+
+  for (std::size_t run = 0; run < runs; ++run)
+  {
+    rl::plan::VectorList path;
+
+    //  Independent runs start cold, --warm-start on lets every run reuse the trees of the one before
+    if (!warmStart)
+    {
+      system.reset();
+    }
+
+    if (system.plan(path))
+    {
+      ++solved;
+    }
+  }
+
+  std::cout << "solved " << solved << " of " << runs << " runs" << std::endl;
+
+  if (NULL != traceFilename)
+  {
+    EventTracer::write(traceFilename);
+  }
+
+  return solved == runs ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,388 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#include <rl/math/Unit.h>
+
+#include "TutorialPlanSystem.h"
+#include "YourPlanner.h"
+#include "YourPlannerPolicies.h"
+#include "YourSampler.h"
+
+//  Microbenchmarks of the planner kernels on the rbo_wall scene.
+//  Every input is drawn from a fixed seed before the timed loop, so two runs
+//  of the same build measure the same work. Build with CMAKE_BUILD_TYPE=Release.
+//
+//  usage: plannerBenchmark [FILTER] [CSV] [SCENE] [KINEMATICS]
+//  Only benchmarks whose name contains FILTER run, CSV appends name,ops,ns/op,allocs/op.
+
+namespace
+{
+  std::atomic< std::size_t > allocations(0);
+}
+
+void*
+operator new(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+
+  if (void* p = std::malloc(0 == size ? 1 : size))
+  {
+    return p;
+  }
+
+  throw std::bad_alloc();
+}
+
+void*
+operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+//  Opens up the protected kernels of the planners for timing.
+class BenchmarkPlanner : public YourPlanner
+{
+public:
+  BenchmarkPlanner() :
+    YourPlanner(rl::plan::DistributionType::UNIFORM)
+  {
+    this->tree.resize(2);
+    this->begin.resize(2);
+    this->end.resize(2);
+  }
+
+  void clear()
+  {
+    this->tree[0].clear();
+    this->tree[1].clear();
+  }
+
+  //  Tree 0 holds the given configurations, all children of the first.
+  void fill(const rl::plan::VectorList& samples)
+  {
+    this->tree[0].clear();
+
+    for (rl::plan::VectorList::const_iterator i = samples.begin(); i != samples.end(); ++i)
+    {
+      Vertex v = this->addVertex(this->tree[0], std::make_shared< rl::math::Vector >(*i));
+
+      if (i != samples.begin())
+      {
+        this->addEdge(*boost::vertices(this->tree[0]).first, v, this->tree[0]);
+      }
+    }
+  }
+
+  //  Both trees become chains of depth vertices from start to goal, joined at their ends.
+  void chain(const rl::math::Vector& start, const rl::math::Vector& goal, const std::size_t& depth)
+  {
+    rl::math::Vector q(start.size());
+
+    for (std::size_t t = 0; t < 2; ++t)
+    {
+      this->tree[t].clear();
+      Vertex previous = Vertex();
+
+      for (std::size_t i = 0; i < depth; ++i)
+      {
+        rl::math::Real alpha = 0.5f * i / depth;
+        this->model->interpolate(0 == t ? start : goal, 0 == t ? goal : start, alpha, q);
+        Vertex v = this->addVertex(this->tree[t], std::make_shared< rl::math::Vector >(q));
+
+        if (0 == i)
+        {
+          this->begin[t] = v;
+        }
+        else
+        {
+          this->addEdge(previous, v, this->tree[t]);
+        }
+
+        previous = v;
+      }
+
+      this->end[t] = previous;
+    }
+  }
+
+  //  Tree 1 holds the root of the connect and extend segments.
+  void root(const rl::math::Vector& q)
+  {
+    this->tree[1].clear();
+    this->begin[1] = this->addVertex(this->tree[1], std::make_shared< rl::math::Vector >(q));
+  }
+
+  Neighbor baseNearest(const rl::math::Vector& q)
+  {
+    return this->RrtConConBase::nearest(this->tree[0], q);
+  }
+
+  Neighbor yourNearest(const rl::math::Vector& q)
+  {
+    return this->nearest(this->tree[0], q);
+  }
+
+  bool baseConnect(const rl::math::Vector& q)
+  {
+    return NULL != this->RrtConConBase::connect(this->tree[1], this->segment(q), q);
+  }
+
+  bool baseExtend(const rl::math::Vector& q)
+  {
+    return NULL != this->RrtConConBase::extend(this->tree[1], this->segment(q), q);
+  }
+
+  bool yourConnect(const rl::math::Vector& q)
+  {
+    return NULL != this->connect(this->tree[1], this->segment(q), q);
+  }
+
+  rl::plan::VectorList path()
+  {
+    return this->RrtConConBase::getPath();
+  }
+
+private:
+  Neighbor segment(const rl::math::Vector& q) const
+  {
+    return Neighbor(this->begin[1], this->model->distance(*this->tree[1][this->begin[1]].q, q));
+  }
+};
+
+namespace
+{
+  const char* filter = "";
+
+  std::ofstream csv;
+
+  //  Runs op ops times after ops / 10 warm-up calls and prints ns/op and allocs/op.
+  template< typename Op >
+  void
+  measure(const std::string& name, std::size_t ops, Op op)
+  {
+    if (std::string::npos == name.find(filter))
+    {
+      return;
+    }
+
+    ops = std::max< std::size_t >(ops, 1);
+
+    for (std::size_t i = 0; i < ops / 10; ++i)
+    {
+      op(i);
+    }
+
+    std::size_t before = allocations.load(std::memory_order_relaxed);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < ops; ++i)
+    {
+      op(i);
+    }
+
+    std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+    std::size_t allocs = allocations.load(std::memory_order_relaxed) - before;
+    double ns = std::chrono::duration_cast< std::chrono::duration< double, std::nano > >(stop - start).count() / ops;
+
+    std::cout << std::left << std::setw(40) << name << std::right
+              << std::setw(10) << ops << " ops "
+              << std::setw(14) << std::fixed << std::setprecision(1) << ns << " ns/op "
+              << std::setw(8) << std::setprecision(2) << static_cast< double >(allocs) / ops << " allocs/op" << std::endl;
+
+    if (csv.is_open())
+    {
+      csv << name << "," << ops << "," << ns << "," << static_cast< double >(allocs) / ops << std::endl;
+    }
+  }
+
+  //  Keeps the optimizer from dropping a result.
+  volatile rl::math::Real sink = 0;
+}
+
+int
+main(int argc, char** argv)
+{
+  filter = argc > 1 ? argv[1] : "";
+
+  if (argc > 2)
+  {
+    csv.open(argv[2], std::ios::app);
+  }
+
+  TutorialPlanSystem system(
+    rl::plan::DistributionType::UNIFORM,
+    argc > 3 ? argv[3] : "../xml/rlsg/unimation-puma560-rbo_wall.xml",
+    argc > 4 ? argv[4] : "../xml/rlkin/unimation-puma560.xml"
+  );
+
+  if (0 == system.getSceneHash())
+  {
+    std::cout << "cannot read scene or kinematics file" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  system.setSeed(0);
+
+  rl::plan::DistanceModel& model = system.getModel();
+  std::size_t dof = model.getDof();
+
+  //  Inputs: random configurations from a fixed seed, drawn outside the timed loops.
+  rl::plan::YourSampler sampler(rl::plan::DistributionType::UNIFORM);
+  sampler.model = &model;
+  sampler.seed(0);
+
+  std::vector< rl::math::Vector > queries;
+
+  for (std::size_t i = 0; i < 4096; ++i)
+  {
+    queries.push_back(sampler.generate());
+  }
+
+  BenchmarkPlanner planner;
+  planner.model = &model;
+  planner.delta = 1 * rl::math::constants::deg2rad;
+  planner.epsilon = 1.0e-8f;
+  planner.weights = rl::math::Vector::LinSpaced(dof, dof, 1);
+
+  //  nearest: linear scan over the tree, model metric and the weighted kernel.
+  for (std::size_t size = 1000; size <= 1000000; size *= 10)
+  {
+    rl::plan::VectorList samples;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      samples.push_back(sampler.generate());
+    }
+
+    planner.fill(samples);
+    samples.clear();
+
+    std::size_t ops = std::max< std::size_t >(20, 20000000 / size);
+    std::string suffix = "/" + std::to_string(size);
+
+    measure("RrtConConBase::nearest" + suffix, ops, [&](std::size_t i) {
+      sink = planner.baseNearest(queries[i % queries.size()]).second;
+    });
+
+    planner.useWeightedMetric = true;
+    measure("YourPlanner::nearest weighted" + suffix, ops, [&](std::size_t i) {
+      sink = planner.yourNearest(queries[i % queries.size()]).second;
+    });
+    planner.useWeightedMetric = false;
+  }
+
+  planner.clear();
+
+  //  connect/extend: fixed segments from the start towards configurations at 10 and 30 delta.
+  rl::math::Vector start = system.getStartConfiguration();
+  std::vector< rl::math::Vector > targets[2];
+
+  for (std::size_t i = 0; i < queries.size(); ++i)
+  {
+    for (std::size_t j = 0; j < 2; ++j)
+    {
+      rl::math::Vector target(dof);
+      rl::math::Real distance = model.distance(start, queries[i]);
+      model.interpolate(start, queries[i], std::min< rl::math::Real >(1, (0 == j ? 10 : 30) * planner.delta / distance), target);
+      targets[j].push_back(target);
+    }
+  }
+
+  for (std::size_t j = 0; j < 2; ++j)
+  {
+    std::string suffix = 0 == j ? " 10 delta" : " 30 delta";
+
+    planner.root(start);
+    measure("RrtConConBase::connect" + suffix, 2000, [&](std::size_t i) {
+      planner.baseConnect(targets[j][i % targets[j].size()]);
+    });
+
+    planner.root(start);
+    measure("YourPlanner::connect" + suffix, 2000, [&](std::size_t i) {
+      planner.yourConnect(targets[j][i % targets[j].size()]);
+    });
+  }
+
+  planner.root(start);
+  measure("RrtConConBase::extend", 20000, [&](std::size_t i) {
+    planner.baseExtend(targets[1][i % targets[1].size()]);
+  });
+
+  //  YourSampler::generate per distribution, the narrow-passage modes pay for collision checks.
+  const char* modeNames[] = {"uniform", "normal", "gaussian", "bridge", "obstacle", "clamped-normal"};
+
+  for (std::size_t m = 0; m < 6; ++m)
+  {
+    sampler.setDistributionType(static_cast< rl::plan::DistributionType >(m));
+    sampler.seed(0);
+    bool narrow = m >= 2 && m <= 4;
+
+    measure(std::string("YourSampler::generate ") + modeNames[m], narrow ? 2000 : 200000, [&](std::size_t i) {
+      sink = sampler.generate()(0);
+    });
+  }
+
+  //  The weighted metric kernel of nearest on its own.
+  measure("WeightedMetric::compare", 10000000, [&](std::size_t i) {
+    sink = WeightedMetric::compare(model, planner.weights, queries[i % queries.size()], queries[(i + 1) % queries.size()]);
+  });
+
+  measure("Model::distance", 10000000, [&](std::size_t i) {
+    sink = model.distance(queries[i % queries.size()], queries[(i + 1) % queries.size()]);
+  });
+
+  //  getPath on two chains joined at their ends.
+  for (std::size_t depth = 1000; depth <= 100000; depth *= 10)
+  {
+    planner.chain(start, system.getGoalConfiguration(), depth);
+
+    measure("RrtConConBase::getPath/" + std::to_string(depth), std::max< std::size_t >(10, 1000000 / depth), [&](std::size_t i) {
+      sink = static_cast< rl::math::Real >(planner.path().size());
+    });
+  }
+
+  planner.clear();
+
+  //  Collision queries on the scene, forward kinematics timed on its own as well.
+  measure("Model::updateFrames", 100000, [&](std::size_t i) {
+    model.setPosition(queries[i % queries.size()]);
+    model.updateFrames();
+  });
+
+  measure("Model::isColliding", 20000, [&](std::size_t i) {
+    model.setPosition(queries[i % queries.size()]);
+    model.updateFrames();
+    sink = model.isColliding() ? 1 : 0;
+  });
+
+  return EXIT_SUCCESS;
+}
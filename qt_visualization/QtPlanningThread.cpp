@@ -56,30 +56,35 @@ QtPlanningThread::~QtPlanningThread()
 void
 QtPlanningThread::drawConfiguration(const rl::math::Vector& q)
 {
+    this->post(CONFIGURATION, &QtPlanningThread::configurationRequested);
     emit configurationRequested(q);
 }
 
 void
 QtPlanningThread::drawConfigurationEdge(const rl::math::Vector& q0, const rl::math::Vector& q1, const bool& free)
 {
+    this->post(CONFIGURATION_EDGE, &QtPlanningThread::configurationEdgeRequested);
     emit configurationEdgeRequested(q0, q1, free);
 }
 
 void
 QtPlanningThread::drawConfigurationPath(const rl::plan::VectorList& path)
 {
+    this->post(CONFIGURATION_PATH, &QtPlanningThread::configurationPathRequested);
     emit configurationPathRequested(path);
 }
 
 void
 QtPlanningThread::drawConfigurationVertex(const rl::math::Vector& q, const bool& free)
 {
+    this->post(CONFIGURATION_VERTEX, &QtPlanningThread::configurationVertexRequested);
     emit configurationVertexRequested(q, free);
 }
 
 void
 QtPlanningThread::drawLine(const rl::math::Vector& xyz0, const rl::math::Vector& xyz1)
 {
+    this->post(LINE, &QtPlanningThread::lineRequested);
     emit lineRequested(xyz0, xyz1);
 }
 
@@ -92,18 +97,21 @@ QtPlanningThread::drawPoint(const rl::math::Vector& xyz)
 void
 QtPlanningThread::drawSphere(const rl::math::Vector& center, const rl::math::Real& radius)
 {
+    this->post(SPHERE, &QtPlanningThread::sphereRequested);
     emit sphereRequested(center, radius);
 }
 
 void
 QtPlanningThread::drawSweptVolume(const rl::plan::VectorList& path)
 {
+    this->post(SWEPT_VOLUME, &QtPlanningThread::sweptVolumeRequested);
     emit sweptVolumeRequested(path);
 }
 
 void
 QtPlanningThread::drawWork(const rl::math::Transform& t)
 {
+    this->post(WORK, &QtPlanningThread::workRequested);
     emit workRequested(t);
 }
 
@@ -116,6 +124,7 @@ QtPlanningThread::drawWorkEdge(const rl::math::Vector& q0, const rl::math::Vecto
 void
 QtPlanningThread::drawWorkPath(const rl::plan::VectorList& path)
 {
+    this->post(WORK_PATH, &QtPlanningThread::workPathRequested);
     emit workPathRequested(path);
 }
 
@@ -128,18 +137,21 @@ QtPlanningThread::drawWorkVertex(const rl::math::Vector& q)
 void
 QtPlanningThread::reset()
 {
+    this->post(RESET, &QtPlanningThread::resetRequested);
     emit resetRequested();
 }
 
 void
 QtPlanningThread::resetEdges()
 {
+    this->post(EDGE_RESET, &QtPlanningThread::edgeResetRequested);
     emit edgeResetRequested();
 }
 
 void
 QtPlanningThread::resetLines()
 {
+    this->post(LINE_RESET, &QtPlanningThread::lineResetRequested);
     emit lineResetRequested();
 }
 
@@ -159,6 +171,7 @@ QtPlanningThread::resetSpheres()
 void
 QtPlanningThread::resetVertices()
 {
+    this->post(VERTEX_RESET, &QtPlanningThread::vertexResetRequested);
     emit vertexResetRequested();
 }
 
@@ -171,6 +184,8 @@ QtPlanningThread::showMessage(const ::std::string& message)
 void
 QtPlanningThread::run()
 {
+    EventTracer::setThreadName("planner");
+
     this->mutex->lock();
     this->running = true;
     this->mutex->unlock();
@@ -213,6 +228,7 @@ QtPlanningThread::run()
 
 void QtPlanningThread::followPath(rl::plan::VectorList& path)
 {
+    EventTracer::Span span("thread", "follow path");
 
 	if(this->stopped())
     {
@@ -30,10 +30,12 @@
 #ifndef _QT_PLANNING_THREAD_H_
 #define _QT_PLANNING_THREAD_H_
 
+#include <QMetaMethod>
 #include <QThread>
 #include <QMutex>
 #include <rl/plan/Viewer.h>
 
+#include "../EventTracer.h"
 #include "../TutorialPlanSystem.h"
 
 class QtPlanningThread : public QThread, public rl::plan::Viewer
@@ -41,6 +43,25 @@ class QtPlanningThread : public QThread, public rl::plan::Viewer
 	Q_OBJECT
 	
 public:
+	/** Lanes of the queued signals the viewer receives, for their latency in the trace */
+	enum Queued
+	{
+		CONFIGURATION,
+		CONFIGURATION_EDGE,
+		CONFIGURATION_PATH,
+		CONFIGURATION_VERTEX,
+		EDGE_RESET,
+		LINE,
+		LINE_RESET,
+		RESET,
+		SPHERE,
+		SWEPT_VOLUME,
+		VERTEX_RESET,
+		WORK,
+		WORK_EDGE,
+		WORK_PATH
+	};
+	
         QtPlanningThread(QMutex *mutex, TutorialPlanSystem* system, rl::plan::Viewer* viewer, QObject* parent = NULL);
 	
         virtual ~QtPlanningThread();
@@ -91,6 +112,9 @@ public:
 	
 	bool swept;
 	
+	/** Emit times of the queued signals, taken by the viewer slots */
+	EventTracer::Channel queue;
+	
 protected:
 	
 private:
@@ -98,6 +122,16 @@ private:
 
         void followPath(rl::plan::VectorList& path);
 
+        /** Posts the emit time of a signal that is connected, unconnected ones never arrive */
+        template< typename Signal >
+        void post(const Queued& lane, Signal signal)
+        {
+            if (EventTracer::isEnabled() && this->isSignalConnected(QMetaMethod::fromSignal(signal)))
+            {
+                this->queue.post(lane);
+            }
+        }
+
 	bool running;
 
         TutorialPlanSystem* system;
@@ -38,6 +38,7 @@
 #include <rl/sg/so/Model.h>
 #include <rl/sg/so/Shape.h>
 
+#include "QtPlanningThread.h"
 #include "QtViewer.h"
 
 QtViewer::QtViewer(QWidget* parent, Qt::WindowFlags f) :
@@ -369,6 +370,8 @@ QtViewer::~QtViewer()
 void
 QtViewer::drawConfiguration(const rl::math::Vector& q)
 {
+    EventTracer::Span span("viewer", "drawConfiguration");
+    this->receive(span, QtPlanningThread::CONFIGURATION);
 
     this->model->setPosition(q);
 
@@ -378,6 +381,9 @@ QtViewer::drawConfiguration(const rl::math::Vector& q)
 void
 QtViewer::drawConfigurationEdge(const rl::math::Vector& u, const rl::math::Vector& v, const bool& free)
 {
+    EventTracer::Span span("viewer", "drawConfigurationEdge");
+    this->receive(span, QtPlanningThread::CONFIGURATION_EDGE);
+
     SoVRMLCoordinate* coordinate = NULL;
     SoVRMLIndexedLineSet* indexedLineSet = NULL;
 
@@ -400,6 +406,47 @@ QtViewer::drawConfigurationEdge(const rl::math::Vector& u, const rl::math::Vecto
 
     rl::math::Real steps = std::ceil(this->model->distance(u, v) / this->delta);
 
+    if (this->batch.isValid())
+    {
+        // The tool positions of all steps in one kinematics pass
+        std::vector<rl::math::Real> alphas;
+        for (std::size_t i = 0; i < steps + 1; ++i)
+        {
+            alphas.push_back(i / steps);
+        }
+
+        BatchKinematics::Block block;
+        this->batch.compute(u, v, alphas, block);
+
+        for (std::size_t i = 0; i < block.size(); ++i)
+        {
+            rl::math::Vector3 position = block.getPosition(BatchKinematics::BODIES, i);
+
+            coordinate->point.set1Value(
+                        coordinate->point.getNum(),
+                        position(0),
+                        position(1),
+                        position(2)
+			);
+
+            indexedLineSet->coordIndex.set1Value(
+                        indexedLineSet->coordIndex.getNum(),
+                        coordinate->point.getNum() - 1
+			);
+        }
+
+        indexedLineSet->coordIndex.set1Value(
+                    indexedLineSet->coordIndex.getNum(),
+                    SO_END_FACE_INDEX
+                    );
+
+        this->edges->enableNotify(true);
+
+        this->edges->touch();
+
+        return;
+    }
+
     for (std::size_t l = 0; l < this->model->kin->getOperationalDof(); ++l)
     {
         for (std::size_t i = 0; i < steps + 1; ++i)
@@ -438,6 +485,8 @@ QtViewer::drawConfigurationEdge(const rl::math::Vector& u, const rl::math::Vecto
 void
 QtViewer::drawConfigurationPath(const rl::plan::VectorList& path)
 {
+    EventTracer::Span span("viewer", "drawConfigurationPath");
+    this->receive(span, QtPlanningThread::CONFIGURATION_PATH);
 
 
     this->path->enableNotify(false);
@@ -511,6 +560,9 @@ QtViewer::drawConfigurationPath(const rl::plan::VectorList& path)
 void
 QtViewer::drawConfigurationVertex(const rl::math::Vector& q, const bool& free)
 {
+    EventTracer::Span span("viewer", "drawConfigurationVertex");
+    this->receive(span, QtPlanningThread::CONFIGURATION_VERTEX);
+
     SoVRMLCoordinate* coordinate = NULL;
 
 
@@ -549,6 +601,8 @@ QtViewer::drawConfigurationVertex(const rl::math::Vector& q, const bool& free)
 void
 QtViewer::drawLine(const rl::math::Vector& xyz0, const rl::math::Vector& xyz1)
 {
+    EventTracer::Span span("viewer", "drawLine");
+    this->receive(span, QtPlanningThread::LINE);
 
 
     this->linesCoordinate->point.set1Value(
@@ -586,6 +640,8 @@ QtViewer::drawLine(const rl::math::Vector& xyz0, const rl::math::Vector& xyz1)
 void
 QtViewer::drawPoint(const rl::math::Vector& xyz)
 {
+    EventTracer::Span span("viewer", "drawPoint");
+
 	this->pointsCoordinate->point.set1Value(
 		this->pointsCoordinate->point.getNum(),
 		xyz(0),
@@ -597,6 +653,8 @@ QtViewer::drawPoint(const rl::math::Vector& xyz)
 void
 QtViewer::drawSphere(const rl::math::Vector& center, const rl::math::Real& radius)
 {
+    EventTracer::Span span("viewer", "drawSphere");
+    this->receive(span, QtPlanningThread::SPHERE);
 
 
     SoVRMLTransform* transform = new SoVRMLTransform();
@@ -621,6 +679,8 @@ QtViewer::drawSphere(const rl::math::Vector& center, const rl::math::Real& radiu
 void
 QtViewer::drawSweptVolume(const rl::plan::VectorList& path)
 {
+    EventTracer::Span span("viewer", "drawSweptVolume");
+    this->receive(span, QtPlanningThread::SWEPT_VOLUME);
 
 
     this->sweptGroup->enableNotify(false);
@@ -701,6 +761,9 @@ QtViewer::drawSweptVolume(const rl::plan::VectorList& path)
 void
 QtViewer::drawWork(const rl::math::Transform& t)
 {
+    EventTracer::Span span("viewer", "drawWork");
+    this->receive(span, QtPlanningThread::WORK);
+
     SbMatrix matrix;
 
 
@@ -721,6 +784,8 @@ QtViewer::drawWork(const rl::math::Transform& t)
 void
 QtViewer::drawWorkEdge(const rl::math::Vector& u, const rl::math::Vector& v)
 {
+    EventTracer::Span span("viewer", "drawWorkEdge");
+    this->receive(span, QtPlanningThread::WORK_EDGE);
 
 
     this->edges3Coordinate->point.set1Value(
@@ -758,6 +823,8 @@ QtViewer::drawWorkEdge(const rl::math::Vector& u, const rl::math::Vector& v)
 void
 QtViewer::drawWorkPath(const rl::plan::VectorList& path)
 {
+    EventTracer::Span span("viewer", "drawWorkPath");
+    this->receive(span, QtPlanningThread::WORK_PATH);
 
 
     this->path3->enableNotify(false);
@@ -797,16 +864,58 @@ QtViewer::drawWorkVertex(const rl::math::Vector& q)
 {
 }
 
+void
+QtViewer::clearEdges()
+{
+    this->edgesCollidingCoordinate->point.setNum(0);
+    this->edgesCollidingIndexedLineSet->coordIndex.setNum(0);
+    this->edgesFreeCoordinate->point.setNum(0);
+    this->edgesFreeIndexedLineSet->coordIndex.setNum(0);
+    this->edges3Coordinate->point.setNum(0);
+    this->edges3IndexedLineSet->coordIndex.setNum(0);
+}
+
+void
+QtViewer::clearLines()
+{
+    this->linesCoordinate->point.setNum(0);
+    this->linesIndexedLineSet->coordIndex.setNum(0);
+}
+
+void
+QtViewer::clearVertices()
+{
+    this->verticesCollidingCoordinate->point.setNum(0);
+    this->verticesFreeCoordinate->point.setNum(0);
+}
+
+void
+QtViewer::receive(EventTracer::Span& span, const int& lane)
+{
+    // Only calls queued by the planning thread were posted, direct calls have no sender
+    QtPlanningThread* thread = qobject_cast< QtPlanningThread* >(this->sender());
+    std::uint64_t posted = 0;
+    std::uint64_t id = 0;
+
+    if (NULL != thread && thread->queue.receive(lane, posted, id))
+    {
+        span.setQueued(posted, id);
+    }
+}
+
 void
 QtViewer::reset()
 {
+    EventTracer::Span span("viewer", "reset");
+    this->receive(span, QtPlanningThread::RESET);
 
 
-    this->resetEdges();
-    this->resetLines();
+    // The untraced helpers, the reset slots would take the queue entries of their own signals
+    this->clearEdges();
+    this->clearLines();
 	this->resetPoints();
 	this->resetSpheres();
-    this->resetVertices();
+    this->clearVertices();
     this->pathCoordinate->point.setNum(0);
     this->pathIndexedLineSet->coordIndex.setNum(0);
     this->path3Coordinate->point.setNum(0);
@@ -821,25 +930,17 @@ QtViewer::reset()
 void
 QtViewer::resetEdges()
 {
-
-
-    this->edgesCollidingCoordinate->point.setNum(0);
-    this->edgesCollidingIndexedLineSet->coordIndex.setNum(0);
-    this->edgesFreeCoordinate->point.setNum(0);
-    this->edgesFreeIndexedLineSet->coordIndex.setNum(0);
-    this->edges3Coordinate->point.setNum(0);
-    this->edges3IndexedLineSet->coordIndex.setNum(0);
-
-
+    EventTracer::Span span("viewer", "resetEdges");
+    this->receive(span, QtPlanningThread::EDGE_RESET);
+    this->clearEdges();
 }
 
 void
 QtViewer::resetLines()
 {
-
-    this->linesCoordinate->point.setNum(0);
-    this->linesIndexedLineSet->coordIndex.setNum(0);
-
+    EventTracer::Span span("viewer", "resetLines");
+    this->receive(span, QtPlanningThread::LINE_RESET);
+    this->clearLines();
 }
 
 void
@@ -857,10 +958,9 @@ QtViewer::resetSpheres()
 void
 QtViewer::resetVertices()
 {
-
-    this->verticesCollidingCoordinate->point.setNum(0);
-    this->verticesFreeCoordinate->point.setNum(0);
-
+    EventTracer::Span span("viewer", "resetVertices");
+    this->receive(span, QtPlanningThread::VERTEX_RESET);
+    this->clearVertices();
 }
 
 void
@@ -48,6 +48,9 @@
 #include <rl/plan/VectorList.h>
 #include <rl/plan/Viewer.h>
 
+#include "../BatchKinematics.h"
+#include "../EventTracer.h"
+
 class QtViewer : public QWidget, public rl::plan::Viewer
 {
 	Q_OBJECT
@@ -61,6 +64,8 @@ public:
 	
 	rl::plan::Model* model;
 	
+	BatchKinematics batch;
+	
 	SoVRMLGroup* sceneGroup;
 	
 	SoQtExaminerViewer* viewer;
@@ -115,6 +120,16 @@ public slots:
 protected:
 	
 private:
+	/** Bodies of resetEdges(), resetLines() and resetVertices() without tracing, for reset() */
+	void clearEdges();
+	
+	void clearLines();
+	
+	void clearVertices();
+	
+	/** Takes the emit time of the queued signal that called the current slot, if any */
+	void receive(EventTracer::Span& span, const int& lane);
+	
 	SoVRMLSwitch* edges;
 	
 	SoVRMLSwitch* edgesColliding;
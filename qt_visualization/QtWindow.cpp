@@ -390,6 +390,7 @@ QtWindow::load()
     this->viewer->sceneGroup->addChild(scene->root);
     this->viewer->model = this->model.get();
     this->viewer->delta = 1.0 * rl::math::constants::deg2rad;
+    this->viewer->batch.calibrate(*this->model);
 
     this->toggleView(true);
     this->toggleViewAction->setChecked(true);
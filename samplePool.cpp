@@ -0,0 +1,58 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "SamplePool.h"
+#include "TutorialPlanSystem.h"
+
+//  Precomputes a pool of collision-free configurations for a static scene.
+//  The pool is tagged with the hash of the scene and kinematics XML files,
+//  tutorialPlan --pool FILE maps it at startup and rejects it once stale.
+//
+//  usage: samplePool OUTPUT [COUNT] [SEED] [SCENE] [KINEMATICS]
+int
+main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cout << "usage: " << argv[0] << " OUTPUT [COUNT] [SEED] [SCENE] [KINEMATICS]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::string output = argv[1];
+  std::size_t count = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 100000;
+  std::mt19937::result_type seed = argc > 3 ? std::strtoul(argv[3], NULL, 10) : 0;
+
+  TutorialPlanSystem system(
+    rl::plan::DistributionType::UNIFORM,
+    argc > 4 ? argv[4] : "../xml/rlsg/unimation-puma560-rbo_wall.xml",
+    argc > 5 ? argv[5] : "../xml/rlkin/unimation-puma560.xml"
+  );
+
+  std::uint64_t hash = system.getSceneHash();
+
+  if (0 == hash)
+  {
+    std::cout << "cannot read scene or kinematics file" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  system.setSeed(seed);
+
+  rl::plan::VectorList samples;
+  rl::math::Vector config(system.getModel().getDof());
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    system.getRandomFreeConfiguration(config);
+    samples.push_back(config);
+  }
+
+  if (!SamplePool::write(output, hash, system.getModel().getDof(), samples))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "wrote " << count << " configurations, " << system.getModel().getTotalQueries() << " collision queries" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -1,7 +1,9 @@
+#include <cstring>
 #include <QApplication>
 #include <Inventor/Qt/SoQt.h>
 
 #include "qt_visualization/QtWindow.h"
+#include "EventTracer.h"
 #include "TutorialPlanSystem.h"
 
 //Initialize the global singleton variable of the main visualization window with null.
@@ -24,6 +26,45 @@ main(int argc, char** argv)
   //  Create the TutorialPlanSystem class which contains our roblib plan system.
   boost::shared_ptr<TutorialPlanSystem> system(new TutorialPlanSystem());
 
+  //  Profiling options: --seed N makes every run deterministic,
+  //  --start/--goal DEGREES set the joint angles, e.g. --start 0,0,90,0,0,0,
+  //  --record FILE / --replay FILE store or reuse the exact sample stream,
+  //  --sampler NAME selects the sampling distribution,
+  //  --pool FILE maps a pool of collision-free configurations built by samplePool, drawn before any --sampler mode,
+  //  --planner rrt|base|prm|lazyprm selects the planner, --roadmap FILE persists the PRM roadmap,
+  //  --planner rrt:POLICIES compiles YourPlanner for e.g. goalbias+weighted+dynamicdomain,
+  //  --anytime SECONDS keeps refining the path after the first solution,
+  //  --warm-start on|off keeps the trees between plans (off by default),
+  //  --weights kinematic|linear selects the joint weights of the weighted metric (linear by default, kinematic caches a .weights file),
+  //  --connect-k K tries the K nearest vertices when connecting the trees,
+  //  --pair-filter on|off checks only the body pairs that can collide instead of the full scene (off by default),
+  //  --collision-index on|off rejects samples next to known collisions without a query (off by default),
+  //  --fk batch|single computes the frames of edge steps a block at a time or one by one,
+  //  --edges discrete|continuous checks edges in delta steps or by conservative advancement,
+  //  --proxy FILE|off selects the proxy scene checked before the exact one (off by default,
+  //  e.g. xml/rlsg/unimation-puma560-rbo_wall.proxy.xml),
+  //  --occupancy FILE persists the joint-space occupancy grid between runs and rejects samples in its colliding cells,
+  //  --optimizer advanced|parallel selects the path post-processing (advanced by default),
+  //  --counters on|off reads hardware counters per phase in a PLANNER_PROFILE build,
+  //  --trace FILE writes a timeline of the planner and GUI threads for chrome://tracing or Perfetto.
+  //  All but --trace are handled by TutorialPlanSystem::setOption, headlessPlan takes the same.
+  const char* traceFilename = NULL;
+
+  for (int i = 1; i + 1 < argc; ++i)
+  {
+    if (0 == std::strcmp(argv[i], "--trace"))
+    {
+      traceFilename = argv[++i];
+      EventTracer::start();
+      EventTracer::setThreadName("gui");
+    }
+    else if (0 == std::strncmp(argv[i], "--", 2))
+    {
+      system->setOption(argv[i] + 2, argv[i + 1]);
+      ++i;
+    }
+  }
+
   //  Create our main visualization window and pass our TutorialPlanSystem to the constructor.
   window = QtWindow::instance(system.get());
 
@@ -31,5 +72,13 @@ main(int argc, char** argv)
   window->show();
 
   //  Run the qt application.
-  return application.exec();
+  int result = application.exec();
+
+  //  The per-thread trace buffers are only read once the run is over.
+  if (NULL != traceFilename)
+  {
+    EventTracer::write(traceFilename);
+  }
+
+  return result;
 }